@@ -6,13 +6,75 @@
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemGlobals.h"
 #include "ExtendedAbilitySet.h"
+#include "Algo/StableSort.h"
+#include "Engine/AssetManager.h"
 #include "Engine/GameInstance.h"
 #include "GameFramework/Pawn.h"
 #include "GameFramework/PlayerState.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(GameFeatureAction_AddAbilities)
 
 
+namespace ExtendedGameFeatureActions
+{
+	/** Return true if an actor belongs to a human player, whose grants take priority over bots. */
+	bool IsPlayerActor(const AActor* Actor)
+	{
+		if (const APawn* Pawn = Cast<APawn>(Actor))
+		{
+			return Pawn->IsPlayerControlled();
+		}
+		if (const APlayerState* PlayerState = Cast<APlayerState>(Actor))
+		{
+			return !PlayerState->IsABot();
+		}
+		return false;
+	}
+}
+
+
+bool UGameFeatureAction_AddAbilities::FAbilityGrantPlan::AllowsActor(const AActor* Actor) const
+{
+	if (bAddToPlayers && bAddToBots)
+	{
+		return true;
+	}
+
+	if (const APawn* Pawn = Cast<APawn>(Actor))
+	{
+		return Pawn->IsPlayerControlled() ? bAddToPlayers : (!Pawn->IsBotControlled() || bAddToBots);
+	}
+	if (const APlayerState* PlayerState = Cast<APlayerState>(Actor))
+	{
+		return PlayerState->IsABot() ? bAddToBots : bAddToPlayers;
+	}
+	return true;
+}
+
+
+void UGameFeatureAction_AddAbilities::FlushPendingGrants()
+{
+	if (GrantTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(GrantTickerHandle);
+		GrantTickerHandle.Reset();
+	}
+
+	ProcessPendingGrants(false);
+}
+
+void UGameFeatureAction_AddAbilities::BeginDestroy()
+{
+	if (GrantTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(GrantTickerHandle);
+		GrantTickerHandle.Reset();
+	}
+
+	Super::BeginDestroy();
+}
+
 UGameFeatureWorldAction::FContextHandles* UGameFeatureAction_AddAbilities::AllocContextHandles() const
 {
 	return new FAbilityContextHandles();
@@ -24,12 +86,18 @@ void UGameFeatureAction_AddAbilities::Reset(FContextHandles& Handles)
 
 	FAbilityContextHandles& AbilityHandles = static_cast<FAbilityContextHandles&>(Handles);
 
-	// remove all abilities
-	while (!AbilityHandles.AbilitySetHandles.IsEmpty())
+	// drop grants that haven't been applied yet
+	AbilityHandles.PendingGrants.Reset();
+	AbilityHandles.GrantPlans.Reset();
+
+	if (AbilityHandles.AbilitySetLoadHandle.IsValid())
 	{
-		const auto ActorSetHandlesIt = AbilityHandles.AbilitySetHandles.CreateIterator();
-		RemoveAbilitySets(ActorSetHandlesIt->Key, AbilityHandles);
+		AbilityHandles.AbilitySetLoadHandle->CancelHandle();
+		AbilityHandles.AbilitySetLoadHandle.Reset();
 	}
+	AbilityHandles.bAbilitySetsLoaded = false;
+
+	RemoveAllAbilitySets(AbilityHandles);
 }
 
 void UGameFeatureAction_AddAbilities::AddToWorld(const FWorldContext& WorldContext, FGameFeatureStateChangeContext ChangeContext)
@@ -49,6 +117,41 @@ void UGameFeatureAction_AddAbilities::AddToWorld(const FWorldContext& WorldConte
 
 	FAbilityContextHandles& Handles = FindOrAddContextHandles<FAbilityContextHandles>(ChangeContext);
 
+	Handles.GrantPlans.SetNum(Abilities.Num());
+	Handles.bAbilitySetsLoaded = false;
+
+	// the sets are usually already loaded with the experience bundles, but the action can also be
+	// activated on its own. hold a handle either way so they stay loaded while the action is active
+	TArray<FSoftObjectPath> AbilitySetPaths;
+	for (int32 Idx = 0; Idx < Abilities.Num(); ++Idx)
+	{
+		const FGameFeatureExtendedAbilitySetEntry& Entry = Abilities[Idx];
+		FAbilityGrantPlan& GrantPlan = Handles.GrantPlans[Idx];
+		GrantPlan.bAddToPlayers = Entry.bAddToPlayers;
+		GrantPlan.bAddToBots = Entry.bAddToBots;
+
+		for (const TSoftObjectPtr<const UExtendedAbilitySet>& AbilitySetPtr : Entry.AbilitySets)
+		{
+			if (!AbilitySetPtr.IsNull())
+			{
+				AbilitySetPaths.AddUnique(AbilitySetPtr.ToSoftObjectPath());
+			}
+		}
+	}
+
+	if (!AbilitySetPaths.IsEmpty())
+	{
+		Handles.AbilitySetLoadHandle = UAssetManager::Get().GetStreamableManager().RequestAsyncLoad(
+			AbilitySetPaths, FStreamableDelegate::CreateUObject(this, &ThisClass::OnAbilitySetsLoaded, ChangeContext),
+			FStreamableManager::AsyncLoadHighPriority);
+	}
+
+	// build grant plans now if nothing needed loading, so existing actors are granted below without waiting a frame
+	if (!Handles.AbilitySetLoadHandle.IsValid() || Handles.AbilitySetLoadHandle->HasLoadCompleted())
+	{
+		OnAbilitySetsLoaded(ChangeContext);
+	}
+
 	for (int32 Idx = 0; Idx < Abilities.Num(); ++Idx)
 	{
 		const FGameFeatureExtendedAbilitySetEntry& Entry = Abilities[Idx];
@@ -70,50 +173,212 @@ void UGameFeatureAction_AddAbilities::AddToWorld(const FWorldContext& WorldConte
 void UGameFeatureAction_AddAbilities::HandleActorExtension(AActor* Actor, FName EventName, int32 EntryIdx, FGameFeatureStateChangeContext Context)
 {
 	FAbilityContextHandles* Handles = FindContextHandles<FAbilityContextHandles>(Context);
-	if (!Handles || !Abilities.IsValidIndex(EntryIdx))
+	if (!Handles || !Handles->GrantPlans.IsValidIndex(EntryIdx))
 	{
 		return;
 	}
 
-	const FGameFeatureExtendedAbilitySetEntry& Entry = Abilities[EntryIdx];
-
-	if (const APawn* Pawn = Cast<APawn>(Actor))
+	if (EventName == UGameFrameworkComponentManager::NAME_ExtensionAdded ||
+		EventName == UGameFrameworkComponentManager::NAME_ReceiverAdded)
 	{
-		if (Pawn->IsPlayerControlled() && !Entry.bAddToPlayers)
+		const FAbilityGrantPlan& GrantPlan = Handles->GrantPlans[EntryIdx];
+		if ((Handles->bAbilitySetsLoaded && GrantPlan.AbilitySets.IsEmpty()) || !GrantPlan.AllowsActor(Actor))
 		{
 			return;
 		}
-		if (Pawn->IsBotControlled() && !Entry.bAddToBots)
+
+		if (!Handles->bAbilitySetsLoaded || ShouldQueueGrants())
 		{
-			return;
+			QueueAbilityGrant(Actor, EntryIdx, *Handles);
+		}
+		else
+		{
+			AddAbilitySets(Actor, GrantPlan, *Handles);
 		}
 	}
-	else if (const APlayerState* PlayerState = Cast<APlayerState>(Actor))
+	else if (EventName == UGameFrameworkComponentManager::NAME_ExtensionRemoved ||
+		EventName == UGameFrameworkComponentManager::NAME_ReceiverRemoved)
 	{
-		if (!PlayerState->IsABot() && !Entry.bAddToPlayers)
+		// cleared instead of removed, since the queue may be in the middle of being processed
+		for (FPendingAbilityGrant& Grant : Handles->PendingGrants)
 		{
-			return;
+			if (Grant.Actor == Actor)
+			{
+				Grant.Actor.Reset();
+				Grant.EntryIndices.Reset();
+			}
 		}
-		if (PlayerState->IsABot() && !Entry.bAddToBots)
+		RemoveAbilitySets(Actor, *Handles);
+	}
+}
+
+void UGameFeatureAction_AddAbilities::BuildGrantPlan(const FGameFeatureExtendedAbilitySetEntry& Entry, FAbilityGrantPlan& OutPlan) const
+{
+	OutPlan.AbilitySets.Reset(Entry.AbilitySets.Num());
+
+	for (const TSoftObjectPtr<const UExtendedAbilitySet>& AbilitySetPtr : Entry.AbilitySets)
+	{
+		if (const UExtendedAbilitySet* AbilitySet = AbilitySetPtr.Get())
 		{
-			return;
+			OutPlan.AbilitySets.Add(AbilitySet);
+		}
+		else if (!AbilitySetPtr.IsNull())
+		{
+			UE_LOG(LogGameFeatures, Warning, TEXT("[%hs] Failed to load ability set, it won't be granted: %s"),
+				__FUNCTION__, *AbilitySetPtr.ToString());
 		}
 	}
+}
 
-	if (EventName == UGameFrameworkComponentManager::NAME_ExtensionAdded ||
-		EventName == UGameFrameworkComponentManager::NAME_ReceiverAdded)
+void UGameFeatureAction_AddAbilities::OnAbilitySetsLoaded(FGameFeatureStateChangeContext Context)
+{
+	FAbilityContextHandles* Handles = FindContextHandles<FAbilityContextHandles>(Context);
+	if (!Handles || Handles->bAbilitySetsLoaded)
 	{
-		AddAbilitySets(Actor, Entry.AbilitySets, *Handles);
+		// removed while loading, or already handled when the load completed immediately
+		return;
 	}
-	else if (EventName == UGameFrameworkComponentManager::NAME_ExtensionRemoved ||
-		EventName == UGameFrameworkComponentManager::NAME_ReceiverRemoved)
+
+	// resolve entries once, instead of for every actor
+	for (int32 Idx = 0; Idx < Abilities.Num(); ++Idx)
 	{
-		RemoveAbilitySets(Actor, *Handles);
+		BuildGrantPlan(Abilities[Idx], Handles->GrantPlans[Idx]);
+	}
+	Handles->bAbilitySetsLoaded = true;
+
+	if (Handles->PendingGrants.IsEmpty())
+	{
+		return;
+	}
+
+	// apply grants for actors that were extended while loading
+	if (ShouldQueueGrants())
+	{
+		if (!GrantTickerHandle.IsValid())
+		{
+			GrantTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::OnGrantTick));
+		}
+	}
+	else
+	{
+		ProcessPendingGrants(false);
+	}
+}
+
+bool UGameFeatureAction_AddAbilities::ShouldQueueGrants() const
+{
+	return MaxGrantsPerFrame > 0 || GrantBudgetMs > 0.f;
+}
+
+void UGameFeatureAction_AddAbilities::QueueAbilityGrant(AActor* Actor, int32 EntryIdx, FAbilityContextHandles& Handles)
+{
+	if (!Actor->HasAuthority())
+	{
+		return;
+	}
+
+	// coalesce entries for the same actor so they're granted together
+	FPendingAbilityGrant* Grant = Handles.PendingGrants.FindByPredicate([Actor](const FPendingAbilityGrant& Other) { return Other.Actor == Actor; });
+	if (!Grant)
+	{
+		Grant = &Handles.PendingGrants.AddDefaulted_GetRef();
+		Grant->Actor = Actor;
+		Handles.bPendingGrantsNeedSort = true;
+	}
+	Grant->EntryIndices.AddUnique(EntryIdx);
+
+	// grants are applied once the ability sets finish loading
+	if (Handles.bAbilitySetsLoaded && !GrantTickerHandle.IsValid())
+	{
+		GrantTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::OnGrantTick));
+	}
+}
+
+bool UGameFeatureAction_AddAbilities::OnGrantTick(float DeltaTime)
+{
+	const bool bHasPendingGrants = ProcessPendingGrants(true);
+	if (!bHasPendingGrants)
+	{
+		GrantTickerHandle.Reset();
+	}
+	return bHasPendingGrants;
+}
+
+bool UGameFeatureAction_AddAbilities::ProcessPendingGrants(bool bUseBudget)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGameFeatureAction_AddAbilities::ProcessPendingGrants);
+
+	const double FrameStartTime = FPlatformTime::Seconds();
+	int32 NumGrantedThisFrame = 0;
+
+	// copy since granting abilities can add or remove contexts
+	TArray<TSharedPtr<FContextHandles>> AllHandles;
+	ContextHandles.GenerateValueArray(AllHandles);
+
+	for (const TSharedPtr<FContextHandles>& HandlesPtr : AllHandles)
+	{
+		FAbilityContextHandles& Handles = static_cast<FAbilityContextHandles&>(*HandlesPtr);
+		if (Handles.PendingGrants.IsEmpty() || !Handles.bAbilitySetsLoaded)
+		{
+			continue;
+		}
+
+		// pawns are usually possessed after they are extended, so check for players when processing instead of when queued,
+		// but only sort again if new grants were queued since
+		if (Handles.bPendingGrantsNeedSort)
+		{
+			Algo::StableSortBy(Handles.PendingGrants, [](const FPendingAbilityGrant& Grant)
+			{
+				return !ExtendedGameFeatureActions::IsPlayerActor(Grant.Actor.Get());
+			});
+			Handles.bPendingGrantsNeedSort = false;
+		}
+
+		// consume grants from the front, and remove them all at once afterward
+		int32 NumConsumed = 0;
+		bool bBudgetExceeded = false;
+		while (NumConsumed < Handles.PendingGrants.Num())
+		{
+			if (bUseBudget &&
+				((MaxGrantsPerFrame > 0 && NumGrantedThisFrame >= MaxGrantsPerFrame) ||
+				(GrantBudgetMs > 0.f && (FPlatformTime::Seconds() - FrameStartTime) * 1000.0 >= GrantBudgetMs)))
+			{
+				bBudgetExceeded = true;
+				break;
+			}
+
+			// granting can queue or clear other pending grants, so take this one out of the queue first
+			const FPendingAbilityGrant Grant = MoveTemp(Handles.PendingGrants[NumConsumed]);
+			++NumConsumed;
+
+			AActor* Actor = Grant.Actor.Get();
+			if (!Actor)
+			{
+				// destroyed or removed while waiting
+				continue;
+			}
+
+			for (const int32 EntryIdx : Grant.EntryIndices)
+			{
+				AddAbilitySets(Actor, Handles.GrantPlans[EntryIdx], Handles);
+			}
+			++NumGrantedThisFrame;
+		}
+
+		// the queue may have been reset while granting if the context was removed
+		Handles.PendingGrants.RemoveAt(0, FMath::Min(NumConsumed, Handles.PendingGrants.Num()));
+
+		if (bBudgetExceeded)
+		{
+			// continue next frame
+			return true;
+		}
 	}
+
+	return false;
 }
 
-void UGameFeatureAction_AddAbilities::AddAbilitySets(AActor* Actor, const TArray<TSoftObjectPtr<const UExtendedAbilitySet>>& AbilitySets,
-                                                     FAbilityContextHandles& Handles)
+void UGameFeatureAction_AddAbilities::AddAbilitySets(AActor* Actor, const FAbilityGrantPlan& GrantPlan, FAbilityContextHandles& Handles)
 {
 	if (!Actor->HasAuthority())
 	{
@@ -122,13 +387,15 @@ void UGameFeatureAction_AddAbilities::AddAbilitySets(AActor* Actor, const TArray
 
 	if (UAbilitySystemComponent* AbilitySystem = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Actor))
 	{
-		TArray<FExtendedAbilitySetHandles>& ActorAbilitySetHandles = Handles.AbilitySetHandles.FindOrAdd(Actor);
+		FActorAbilitySetHandles& ActorHandles = Handles.AbilitySetHandles.FindOrAdd(Actor);
+		ActorHandles.AbilitySystem = AbilitySystem;
+		ActorHandles.AbilitySetHandles.Reserve(ActorHandles.AbilitySetHandles.Num() + GrantPlan.AbilitySets.Num());
 
-		for (const TSoftObjectPtr<const UExtendedAbilitySet>& AbilitySetPtr : AbilitySets)
+		for (const TWeakObjectPtr<const UExtendedAbilitySet>& AbilitySetPtr : GrantPlan.AbilitySets)
 		{
 			if (const UExtendedAbilitySet* AbilitySet = AbilitySetPtr.Get())
 			{
-				ActorAbilitySetHandles.Emplace(AbilitySet->GiveToAbilitySystem(AbilitySystem, this));
+				ActorHandles.AbilitySetHandles.Emplace(AbilitySet->GiveToAbilitySystem(AbilitySystem, this));
 			}
 		}
 	}
@@ -136,17 +403,17 @@ void UGameFeatureAction_AddAbilities::AddAbilitySets(AActor* Actor, const TArray
 
 void UGameFeatureAction_AddAbilities::RemoveAbilitySets(AActor* Actor, FAbilityContextHandles& Handles)
 {
-	TArray<FExtendedAbilitySetHandles>* ActorAbilitySetHandles = Handles.AbilitySetHandles.Find(Actor);
-	if (!ActorAbilitySetHandles)
+	FActorAbilitySetHandles* ActorHandles = Handles.AbilitySetHandles.Find(Actor);
+	if (!ActorHandles)
 	{
 		// no record of extending this actor
 		return;
 	}
 
-	if (UAbilitySystemComponent* AbilitySystem = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Actor))
+	if (UAbilitySystemComponent* AbilitySystem = ActorHandles->AbilitySystem.Get())
 	{
 		// remove the granted ability sets
-		for (FExtendedAbilitySetHandles& AbilitySetHandles : *ActorAbilitySetHandles)
+		for (FExtendedAbilitySetHandles& AbilitySetHandles : ActorHandles->AbilitySetHandles)
 		{
 			if (AbilitySetHandles.AbilitySet)
 			{
@@ -157,3 +424,60 @@ void UGameFeatureAction_AddAbilities::RemoveAbilitySets(AActor* Actor, FAbilityC
 
 	Handles.AbilitySetHandles.Remove(Actor);
 }
+
+void UGameFeatureAction_AddAbilities::RemoveAllAbilitySets(FAbilityContextHandles& Handles)
+{
+	if (Handles.AbilitySetHandles.IsEmpty())
+	{
+		return;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGameFeatureAction_AddAbilities::RemoveAllAbilitySets);
+
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 NumActors = Handles.AbilitySetHandles.Num();
+
+	// group by ability system component, e.g. a pawn and player state can share one
+	TMap<UAbilitySystemComponent*, TArray<TArray<FExtendedAbilitySetHandles>*>> HandlesByAbilitySystem;
+	HandlesByAbilitySystem.Reserve(NumActors);
+
+	int32 NumDestroyedActors = 0;
+	for (TPair<TWeakObjectPtr<AActor>, FActorAbilitySetHandles>& Elem : Handles.AbilitySetHandles)
+	{
+		if (!Elem.Key.IsValid())
+		{
+			++NumDestroyedActors;
+		}
+
+		// the ability system may outlive the actor, e.g. when it's on the player state of a destroyed pawn,
+		// so abilities are still removed from it. if it's gone too, the abilities went with it
+		if (UAbilitySystemComponent* AbilitySystem = Elem.Value.AbilitySystem.Get())
+		{
+			HandlesByAbilitySystem.FindOrAdd(AbilitySystem).Add(&Elem.Value.AbilitySetHandles);
+		}
+	}
+
+	for (const TPair<UAbilitySystemComponent*, TArray<TArray<FExtendedAbilitySetHandles>*>>& Elem : HandlesByAbilitySystem)
+	{
+		UAbilitySystemComponent* AbilitySystem = Elem.Key;
+
+		// defer changes to the ability list until every set has been removed from this component
+		FScopedAbilityListLock AbilityListLock(*AbilitySystem);
+
+		for (TArray<FExtendedAbilitySetHandles>* ActorAbilitySetHandles : Elem.Value)
+		{
+			for (FExtendedAbilitySetHandles& AbilitySetHandles : *ActorAbilitySetHandles)
+			{
+				if (AbilitySetHandles.AbilitySet)
+				{
+					AbilitySetHandles.AbilitySet->RemoveFromAbilitySystem(AbilitySystem, AbilitySetHandles);
+				}
+			}
+		}
+	}
+
+	Handles.AbilitySetHandles.Empty();
+
+	UE_LOG(LogGameFeatures, Verbose, TEXT("[%hs] Removed abilities from %d actors (%d destroyed, %d ability systems) in %.2f ms"),
+		__FUNCTION__, NumActors, NumDestroyedActors, HandlesByAbilitySystem.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
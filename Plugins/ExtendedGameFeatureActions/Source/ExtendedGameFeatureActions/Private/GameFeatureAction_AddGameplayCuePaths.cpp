@@ -4,10 +4,16 @@
 #include "GameFeatureAction_AddGameplayCuePaths.h"
 
 #include "AbilitySystemGlobals.h"
+#include "AbilitySystemLog.h"
 #include "GameFeatureData.h"
 #include "GameFeaturesSubsystem.h"
 #include "GameplayCueManager.h"
+#include "GameplayCueNotify_Static.h"
 #include "GameplayCueSet.h"
+#include "GameplayTagsManager.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/Blueprint.h"
+#include "HAL/IConsoleManager.h"
 
 #if WITH_EDITOR
 #include "Misc/DataValidation.h"
@@ -17,6 +23,13 @@
 #define LOCTEXT_NAMESPACE "UGameFeatureAction_AddGameplayCuePaths"
 
 
+TAutoConsoleVariable CVarIncrementalCuePaths(
+	TEXT("gamefeatures.IncrementalCuePaths"),
+	false,
+	TEXT("When registering game features, scan only their gameplay cue paths and merge them into the runtime cue set, instead of rebuilding the whole cue library. ")
+	TEXT("Cues merged this way are not async loaded by the gameplay cue manager, so only enable this if cue classes are loaded on demand or by the feature."));
+
+
 // UGameFeatureAction_AddGameplayCuePaths
 // --------------------------------------
 
@@ -57,24 +70,38 @@ void UGameFeature_AddGameplayCuePaths::OnGameFeatureRegistering(const UGameFeatu
 		return;
 	}
 
-	// register paths for each AddGameplayCuePaths action
-	for (UGameFeatureAction* Action : GameFeatureData->GetActions())
+	const TArray<FString> CuePaths = GetGameplayCuePaths(GameFeatureData, PluginName);
+	if (CuePaths.IsEmpty())
 	{
-		const UGameFeatureAction_AddGameplayCuePaths* AddCuePathsAction = Cast<UGameFeatureAction_AddGameplayCuePaths>(Action);
-		if (!AddCuePathsAction || AddCuePathsAction->GameplayCuePaths.IsEmpty())
-		{
-			continue;
-		}
+		return;
+	}
 
-		// add all paths from the action
-		for (const FDirectoryPath& PathToAdd : AddCuePathsAction->GameplayCuePaths)
-		{
-			FString AdjustedPath = FixGameplayCuePath(PathToAdd, PluginName);
-			GameplayCueManager->AddGameplayCueNotifyPath(AdjustedPath);
-		}
+	for (const FString& CuePath : CuePaths)
+	{
+		GameplayCueManager->AddGameplayCueNotifyPath(CuePath, /*bShouldRescanCueAssets*/ false);
+	}
 
-		// rebuild cue library
-		GameplayCueManager->InitializeRuntimeObjectLibrary();
+	UGameplayCueSet* RuntimeCueSet = GameplayCueManager->GetRuntimeCueSet();
+	if (!CVarIncrementalCuePaths.GetValueOnGameThread() || !RuntimeCueSet)
+	{
+		RequestCueLibraryRebuild();
+		return;
+	}
+
+	// scan only this plugin's paths and merge them into the existing cue set
+	TArray<FGameplayCueReferencePair> CuesToAdd;
+	FindGameplayCues(CuePaths, CuesToAdd);
+
+	TArray<FSoftObjectPath>& CueRefs = PluginCueRefs.FindOrAdd(PluginURL);
+	for (const FGameplayCueReferencePair& Cue : CuesToAdd)
+	{
+		CueRefs.Add(Cue.StringRef);
+	}
+
+	if (!RebuildTickerHandle.IsValid())
+	{
+		// a pending full rebuild will already include them
+		RuntimeCueSet->AddCues(CuesToAdd);
 	}
 }
 
@@ -88,26 +115,121 @@ void UGameFeature_AddGameplayCuePaths::OnGameFeatureUnregistering(const UGameFea
 		return;
 	}
 
+	const TArray<FString> CuePaths = GetGameplayCuePaths(GameFeatureData, PluginName);
+	if (CuePaths.IsEmpty())
+	{
+		return;
+	}
+
+	for (const FString& CuePath : CuePaths)
+	{
+		GameplayCueManager->RemoveGameplayCueNotifyPath(CuePath, /*bShouldRescanCueAssets*/ false);
+	}
+
+	TArray<FSoftObjectPath> CueRefs;
+	const bool bWasIncremental = PluginCueRefs.RemoveAndCopyValue(PluginURL, CueRefs);
+
+	UGameplayCueSet* RuntimeCueSet = GameplayCueManager->GetRuntimeCueSet();
+	if (!CVarIncrementalCuePaths.GetValueOnGameThread() || !RuntimeCueSet || !bWasIncremental)
+	{
+		RequestCueLibraryRebuild();
+		return;
+	}
+
+	if (!RebuildTickerHandle.IsValid())
+	{
+		// remove exactly the cues that were added for this plugin
+		RuntimeCueSet->RemoveCuesByStringRefs(CueRefs);
+	}
+}
+
+void UGameFeature_AddGameplayCuePaths::OnGameFeatureActivating(const UGameFeatureData* GameFeatureData, const FString& PluginURL)
+{
+	// a plugin can register and activate in the same frame, so make sure its cues are in the library before it's used
+	FlushCueLibraryRebuild();
+}
+
+TArray<FString> UGameFeature_AddGameplayCuePaths::GetGameplayCuePaths(const UGameFeatureData* GameFeatureData, const FString& PluginName)
+{
+	TArray<FString> CuePaths;
+
 	for (UGameFeatureAction* Action : GameFeatureData->GetActions())
 	{
 		const UGameFeatureAction_AddGameplayCuePaths* AddCuePathsAction = Cast<UGameFeatureAction_AddGameplayCuePaths>(Action);
-		if (!AddCuePathsAction || AddCuePathsAction->GameplayCuePaths.IsEmpty())
+		if (!AddCuePathsAction)
 		{
 			continue;
 		}
 
-		// remove all paths from the action
-		for (const FDirectoryPath& PathToAdd : AddCuePathsAction->GameplayCuePaths)
+		for (const FDirectoryPath& CuePath : AddCuePathsAction->GameplayCuePaths)
 		{
-			FString AdjustedPath = FixGameplayCuePath(PathToAdd, PluginName);
-			GameplayCueManager->RemoveGameplayCueNotifyPath(AdjustedPath, /*bShouldRescanCueAssets*/ false);
+			CuePaths.AddUnique(FixGameplayCuePath(CuePath, PluginName));
 		}
+	}
 
-		// rebuild cue library
-		GameplayCueManager->InitializeRuntimeObjectLibrary();
+	return CuePaths;
+}
+
+void UGameFeature_AddGameplayCuePaths::FindGameplayCues(const TArray<FString>& CuePaths, TArray<FGameplayCueReferencePair>& OutCues)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGameFeature_AddGameplayCuePaths::FindGameplayCues);
+
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+
+	// same tag used by gameplay cue notify actors and statics
+	static const FName GameplayCueNameTag = GET_MEMBER_NAME_CHECKED(UGameplayCueNotify_Static, GameplayCueName);
+
+	FARFilter Filter;
+	Filter.bRecursivePaths = true;
+	Filter.TagsAndValues.Add(GameplayCueNameTag);
+	for (const FString& CuePath : CuePaths)
+	{
+		Filter.PackagePaths.Add(FName(CuePath));
+	}
+
+#if WITH_EDITOR
+	if (AssetRegistry.IsLoadingAssets())
+	{
+		AssetRegistry.ScanPathsSynchronous(CuePaths);
+	}
+#endif
+
+	TArray<FAssetData> AssetDataList;
+	AssetRegistry.GetAssets(Filter, AssetDataList);
+
+	UGameplayTagsManager& TagsManager = UGameplayTagsManager::Get();
+	for (const FAssetData& AssetData : AssetDataList)
+	{
+		const FName CueTagName = AssetData.GetTagValueRef<FName>(GameplayCueNameTag);
+		const FString GeneratedClassPath = AssetData.GetTagValueRef<FString>(FBlueprintTags::GeneratedClassPath);
+		if (CueTagName.IsNone() || GeneratedClassPath.IsEmpty())
+		{
+			continue;
+		}
+
+		const FSoftObjectPath StringRef(FPackageName::ExportTextPathToObjectPath(GeneratedClassPath));
+		const FGameplayTag CueTag = TagsManager.RequestGameplayTag(CueTagName, false);
+		if (StringRef.IsNull() || !CueTag.IsValid())
+		{
+			UE_LOG(LogAbilitySystem, Warning, TEXT("Found gameplay cue %s with an invalid tag: %s"), *AssetData.GetObjectPathString(), *CueTagName.ToString());
+			continue;
+		}
+
+		OutCues.Emplace(CueTag, StringRef);
 	}
 }
 
+void UGameFeature_AddGameplayCuePaths::BeginDestroy()
+{
+	if (RebuildTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(RebuildTickerHandle);
+		RebuildTickerHandle.Reset();
+	}
+
+	Super::BeginDestroy();
+}
+
 FString UGameFeature_AddGameplayCuePaths::FixGameplayCuePath(const FDirectoryPath& RelativeCuePath, const FString& PluginName)
 {
 	const FString PluginRootPath = TEXT("/") + PluginName;
@@ -116,4 +238,41 @@ FString UGameFeature_AddGameplayCuePaths::FixGameplayCuePath(const FDirectoryPat
 	return AdjustedPath;
 }
 
+void UGameFeature_AddGameplayCuePaths::FlushCueLibraryRebuild()
+{
+	if (!RebuildTickerHandle.IsValid())
+	{
+		return;
+	}
+
+	FTSTicker::GetCoreTicker().RemoveTicker(RebuildTickerHandle);
+	RebuildTickerHandle.Reset();
+
+	if (UGameplayCueManager* GameplayCueManager = UAbilitySystemGlobals::Get().GetGameplayCueManager())
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(UGameFeature_AddGameplayCuePaths::RebuildCueLibrary);
+
+		GameplayCueManager->InitializeRuntimeObjectLibrary();
+	}
+}
+
+void UGameFeature_AddGameplayCuePaths::RequestCueLibraryRebuild()
+{
+	if (RebuildTickerHandle.IsValid())
+	{
+		// already pending, the rebuild will include these changes
+		return;
+	}
+
+	RebuildTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::OnRebuildTick));
+}
+
+bool UGameFeature_AddGameplayCuePaths::OnRebuildTick(float DeltaTime)
+{
+	FlushCueLibraryRebuild();
+
+	// only tick once
+	return false;
+}
+
 #undef LOCTEXT_NAMESPACE
@@ -5,7 +5,10 @@
 
 #include "CommonActivatableWidget.h"
 #include "CommonUIExtensions.h"
+#include "GameFeatureWidgetPoolSubsystem.h"
+#include "PrimaryGameLayout.h"
 #include "UIExtensionSystem.h"
+#include "Blueprint/UserWidget.h"
 #include "Engine/GameInstance.h"
 #include "GameFramework/HUD.h"
 #include "GameFramework/PlayerState.h"
@@ -45,6 +48,11 @@ void UGameFeatureAction_AddWidgets::Reset(FContextHandles& Handles)
 	}
 
 	WidgetHandles.ActorData.Empty();
+
+	if (WidgetHandles.WidgetPool.IsValid())
+	{
+		WidgetHandles.WidgetPool->RemoveLayoutWidgets(this);
+	}
 }
 
 void UGameFeatureAction_AddWidgets::AddToWorld(const FWorldContext& WorldContext, FGameFeatureStateChangeContext ChangeContext)
@@ -63,6 +71,7 @@ void UGameFeatureAction_AddWidgets::AddToWorld(const FWorldContext& WorldContext
 	}
 
 	FWidgetContextHandles& Handles = FindOrAddContextHandles<FWidgetContextHandles>(ChangeContext);
+	Handles.WidgetPool = World->GetSubsystem<UGameFeatureWidgetPoolSubsystem>();
 
 	// listen for actor registration
 	const TSoftClassPtr<AActor> ActorClassPtr = !ActorClass.IsNull() ? ActorClass : AHUD::StaticClass();
@@ -136,7 +145,9 @@ void UGameFeatureAction_AddWidgets::AddWidgets(AActor* Actor, FWidgetContextHand
 	{
 		if (const TSubclassOf<UCommonActivatableWidget> WidgetClass = Entry.WidgetClass.Get())
 		{
-			UCommonActivatableWidget* Layout = UCommonUIExtensions::PushContentToLayer_ForPlayer(LocalPlayer, Entry.Layer, WidgetClass);
+			UCommonActivatableWidget* Layout = bPoolLayoutWidgets
+				? AddPooledLayoutWidget(LocalPlayer, Entry.Layer, WidgetClass, Handles)
+				: UCommonUIExtensions::PushContentToLayer_ForPlayer(LocalPlayer, Entry.Layer, WidgetClass);
 			ActorData.Layouts.Add(Layout);
 		}
 	}
@@ -163,7 +174,13 @@ void UGameFeatureAction_AddWidgets::RemoveWidgets(AActor* Actor, FWidgetContextH
 	{
 		if (Layout.IsValid())
 		{
+			// deactivating removes the widget from its layer
 			Layout->DeactivateWidget();
+
+			if (bPoolLayoutWidgets && Handles.WidgetPool.IsValid())
+			{
+				Handles.WidgetPool->ReleaseLayoutWidget(Layout.Get(), this);
+			}
 		}
 	}
 	for (FUIExtensionHandle& ExtensionHandle : ActorData->ExtensionHandles)
@@ -173,3 +190,31 @@ void UGameFeatureAction_AddWidgets::RemoveWidgets(AActor* Actor, FWidgetContextH
 
 	Handles.ActorData.Remove(Actor);
 }
+
+UCommonActivatableWidget* UGameFeatureAction_AddWidgets::AddPooledLayoutWidget(ULocalPlayer* LocalPlayer, const FGameplayTag& Layer,
+                                                                               TSubclassOf<UCommonActivatableWidget> WidgetClass,
+                                                                               FWidgetContextHandles& Handles)
+{
+	UPrimaryGameLayout* RootLayout = UPrimaryGameLayout::GetPrimaryGameLayout(LocalPlayer);
+	UCommonActivatableWidgetContainerBase* LayerWidget = RootLayout ? RootLayout->GetLayerWidget(Layer) : nullptr;
+	if (!LayerWidget)
+	{
+		return nullptr;
+	}
+
+	UCommonActivatableWidget* Layout = Handles.WidgetPool.IsValid()
+		? Handles.WidgetPool->AcquireLayoutWidget(LocalPlayer, LayerWidget, WidgetClass)
+		: nullptr;
+
+	if (!Layout)
+	{
+		// created here instead of by the layer, so that the layer's own widget pool never hands it out to anyone else
+		Layout = CreateWidget<UCommonActivatableWidget>(LayerWidget, WidgetClass);
+	}
+
+	if (Layout)
+	{
+		LayerWidget->AddWidgetInstance(*Layout);
+	}
+	return Layout;
+}
@@ -0,0 +1,80 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+
+#include "GameFeatureWidgetPoolSubsystem.h"
+
+#include "CommonActivatableWidget.h"
+#include "PrimaryGameLayout.h"
+#include "Widgets/CommonActivatableWidgetContainer.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GameFeatureWidgetPoolSubsystem)
+
+
+UCommonActivatableWidget* UGameFeatureWidgetPoolSubsystem::AcquireLayoutWidget(const ULocalPlayer* LocalPlayer,
+                                                                               const UCommonActivatableWidgetContainerBase* Layer,
+                                                                               TSubclassOf<UCommonActivatableWidget> WidgetClass)
+{
+	PruneLayoutWidgets();
+
+	const int32 PooledIdx = PooledLayoutWidgets.IndexOfByPredicate([LocalPlayer, Layer, WidgetClass](const FGameFeaturePooledLayoutWidget& Pooled)
+	{
+		return Pooled.LocalPlayer == LocalPlayer && Pooled.Layer == Layer && Pooled.Widget->GetClass() == WidgetClass;
+	});
+	if (PooledIdx == INDEX_NONE)
+	{
+		return nullptr;
+	}
+
+	UCommonActivatableWidget* Widget = PooledLayoutWidgets[PooledIdx].Widget;
+	PooledLayoutWidgets.RemoveAtSwap(PooledIdx);
+	return Widget;
+}
+
+void UGameFeatureWidgetPoolSubsystem::ReleaseLayoutWidget(UCommonActivatableWidget* Widget, const UObject* Owner)
+{
+	if (!Widget)
+	{
+		return;
+	}
+
+	// pooled widgets are only reused in the layer they were created in, which is their outer
+	FGameFeaturePooledLayoutWidget& Pooled = PooledLayoutWidgets.AddDefaulted_GetRef();
+	Pooled.Widget = Widget;
+	Pooled.Layer = Widget->GetTypedOuter<UCommonActivatableWidgetContainerBase>();
+	Pooled.LocalPlayer = Widget->GetOwningLocalPlayer();
+	Pooled.Owner = Owner;
+
+	PruneLayoutWidgets();
+}
+
+void UGameFeatureWidgetPoolSubsystem::RemoveLayoutWidgets(const UObject* Owner)
+{
+	PooledLayoutWidgets.RemoveAll([Owner](const FGameFeaturePooledLayoutWidget& Pooled) { return Pooled.Owner == Owner; });
+}
+
+void UGameFeatureWidgetPoolSubsystem::Deinitialize()
+{
+	PooledLayoutWidgets.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UGameFeatureWidgetPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UGameFeatureWidgetPoolSubsystem::PruneLayoutWidgets()
+{
+	// pooled widgets keep their layer and root layout alive through their outer,
+	// so drop them once the player has moved on to a new root layout
+	PooledLayoutWidgets.RemoveAll([](const FGameFeaturePooledLayoutWidget& Pooled)
+	{
+		if (!Pooled.Widget || !Pooled.Layer.IsValid() || !Pooled.LocalPlayer.IsValid())
+		{
+			return true;
+		}
+		const UPrimaryGameLayout* RootLayout = UPrimaryGameLayout::GetPrimaryGameLayout(Pooled.LocalPlayer.Get());
+		return !RootLayout || Pooled.Layer->GetTypedOuter<UPrimaryGameLayout>() != RootLayout;
+	});
+}
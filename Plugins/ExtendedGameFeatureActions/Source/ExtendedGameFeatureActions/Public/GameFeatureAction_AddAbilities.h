@@ -4,11 +4,14 @@
 
 #include "CoreMinimal.h"
 #include "ExtendedAbilitySet.h"
+#include "Containers/Ticker.h"
 #include "GameFeaturesSubsystem.h"
 #include "GameFeatureWorldAction.h"
 #include "GameFeatureAction_AddAbilities.generated.h"
 
+class UAbilitySystemComponent;
 class UExtendedAbilitySet;
+struct FStreamableHandle;
 
 
 /**
@@ -51,18 +54,96 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Abilities")
 	TArray<FGameFeatureExtendedAbilitySetEntry> Abilities;
 
+	/**
+	 * The maximum number of actors to grant abilities to each frame, or 0 for no limit.
+	 * When this or the time budget is set, grants are queued and applied on following frames,
+	 * with player-controlled actors before bots.
+	 */
+	UPROPERTY(EditAnywhere, Meta = (ClampMin = "0"), Category = "Performance")
+	int32 MaxGrantsPerFrame = 0;
+
+	/** The time budget per frame for granting queued abilities, or 0 for no limit. */
+	UPROPERTY(EditAnywhere, Meta = (ClampMin = "0", Units = "ms"), Category = "Performance")
+	float GrantBudgetMs = 0.f;
+
+	/** Grant all queued abilities now. */
+	void FlushPendingGrants();
+
+	virtual void BeginDestroy() override;
+
 protected:
+	/**
+	 * An entry resolved when the action is added to a world,
+	 * so that extending each actor doesn't need to resolve it again.
+	 */
+	struct FAbilityGrantPlan
+	{
+		/** The loaded ability sets to grant. */
+		TArray<TWeakObjectPtr<const UExtendedAbilitySet>> AbilitySets;
+
+		bool bAddToPlayers = true;
+		bool bAddToBots = true;
+
+		/** Return true if the ability sets should be granted to an actor. */
+		bool AllowsActor(const AActor* Actor) const;
+	};
+
+	/** An actor waiting for the ability sets of one or more entries to be granted. */
+	struct FPendingAbilityGrant
+	{
+		TWeakObjectPtr<AActor> Actor;
+
+		/** The indices of the FGameFeatureExtendedAbilitySetEntry to grant. */
+		TArray<int32> EntryIndices;
+	};
+
+	/** The ability sets granted to an actor. */
+	struct FActorAbilitySetHandles
+	{
+		/**
+		 * The ability system the sets were granted to, which may outlive the actor,
+		 * e.g. when it belongs to the player state of a destroyed pawn.
+		 */
+		TWeakObjectPtr<UAbilitySystemComponent> AbilitySystem;
+
+		TArray<FExtendedAbilitySetHandles> AbilitySetHandles;
+	};
+
 	struct FAbilityContextHandles final : public FContextHandles
 	{
-		/** Handles tracking which abilities and effects were granted to each actor, for removal later. */
-		TMap<AActor*, TArray<FExtendedAbilitySetHandles>> AbilitySetHandles;
+		/**
+		 * Handles tracking which abilities and effects were granted to each actor, for removal later.
+		 * Keys are weak, so abilities granted to destroyed actors are removed using the recorded ability system.
+		 */
+		TMap<TWeakObjectPtr<AActor>, FActorAbilitySetHandles> AbilitySetHandles;
+
+		/**
+		 * Actors waiting to be granted abilities, in the order they were extended.
+		 * Entries are cleared instead of removed while queued, and consumed from the front.
+		 */
+		TArray<FPendingAbilityGrant> PendingGrants;
+
+		/** True when grants were queued since PendingGrants was last sorted. */
+		bool bPendingGrantsNeedSort = false;
+
+		/** The grant plan for each entry in Abilities, by index. */
+		TArray<FAbilityGrantPlan> GrantPlans;
+
+		/** Handle keeping the ability sets of all entries loaded. */
+		TSharedPtr<FStreamableHandle> AbilitySetLoadHandle;
+
+		/** True once the ability sets have loaded and grant plans are built. Grants are queued until then. */
+		bool bAbilitySetsLoaded = false;
 
 		virtual bool IsEmpty() const override
 		{
-			return FContextHandles::IsEmpty() && AbilitySetHandles.IsEmpty();
+			return FContextHandles::IsEmpty() && AbilitySetHandles.IsEmpty() && PendingGrants.IsEmpty();
 		}
 	};
 
+	/** Handle for the ticker that grants queued abilities. */
+	FTSTicker::FDelegateHandle GrantTickerHandle;
+
 	virtual FContextHandles* AllocContextHandles() const override;
 	virtual void Reset(FContextHandles& Handles) override;
 	virtual void AddToWorld(const FWorldContext& WorldContext, FGameFeatureStateChangeContext ChangeContext) override;
@@ -73,9 +154,30 @@ protected:
 	 */
 	void HandleActorExtension(AActor* Actor, FName EventName, int32 EntryIdx, FGameFeatureStateChangeContext Context);
 
-	/** Add all ability sets in an entry to an actor, and store the handles. */
-	void AddAbilitySets(AActor* Actor, const TArray<TSoftObjectPtr<const UExtendedAbilitySet>>& AbilitySets, FAbilityContextHandles& Handles);
+	/** Resolve the ability sets of an entry. */
+	void BuildGrantPlan(const FGameFeatureExtendedAbilitySetEntry& Entry, FAbilityGrantPlan& OutPlan) const;
+
+	/** Called when the ability sets for a context have loaded, to build grant plans and apply any queued grants. */
+	void OnAbilitySetsLoaded(FGameFeatureStateChangeContext Context);
+
+	/** Return true if grants should be queued instead of applied immediately. */
+	bool ShouldQueueGrants() const;
+
+	/** Queue the ability sets of an entry to be granted to an actor, merging with any grant already queued for it. */
+	void QueueAbilityGrant(AActor* Actor, int32 EntryIdx, FAbilityContextHandles& Handles);
+
+	/** Grant queued abilities within the per-frame budget. */
+	bool OnGrantTick(float DeltaTime);
+
+	/** Grant queued abilities until the queue is empty or the budget is exceeded. Returns true if any grants remain. */
+	bool ProcessPendingGrants(bool bUseBudget);
+
+	/** Add all ability sets in a grant plan to an actor, and store the handles. */
+	void AddAbilitySets(AActor* Actor, const FAbilityGrantPlan& GrantPlan, FAbilityContextHandles& Handles);
 
 	/** Remove all ability sets added for an actor by handles. */
 	void RemoveAbilitySets(AActor* Actor, FAbilityContextHandles& Handles);
+
+	/** Remove all ability sets added to every actor by handles, grouped by ability system component. */
+	void RemoveAllAbilitySets(FAbilityContextHandles& Handles);
 };
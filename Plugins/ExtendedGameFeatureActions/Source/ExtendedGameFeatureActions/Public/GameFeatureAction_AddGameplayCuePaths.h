@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/Ticker.h"
 #include "GameFeatureAction.h"
 #include "GameFeatureStateChangeObserver.h"
 #include "GameFeatureAction_AddGameplayCuePaths.generated.h"
@@ -32,6 +33,12 @@ public:
 /**
  * A game feature observer used in the game features project policy to
  * add and remove gameplay cue paths as game features register/unregister.
+ * Path changes are applied immediately, but the cue library is only rebuilt once
+ * per frame, no matter how many actions or plugins changed paths during that frame.
+ *
+ * When gamefeatures.IncrementalCuePaths is enabled, registering a plugin only scans that
+ * plugin's cue paths and merges the cues into the runtime cue set, and unregistering
+ * removes exactly those cues, without rebuilding the whole library.
  */
 UCLASS()
 class UGameFeature_AddGameplayCuePaths : public UObject,
@@ -43,6 +50,30 @@ public:
 	// IGameFeatureStateChangeObserver
 	virtual void OnGameFeatureRegistering(const UGameFeatureData* GameFeatureData, const FString& PluginName, const FString& PluginURL) override;
 	virtual void OnGameFeatureUnregistering(const UGameFeatureData* GameFeatureData, const FString& PluginName, const FString& PluginURL) override;
+	virtual void OnGameFeatureActivating(const UGameFeatureData* GameFeatureData, const FString& PluginURL) override;
+
+	virtual void BeginDestroy() override;
 
 	FString FixGameplayCuePath(const FDirectoryPath& RelativeCuePath, const FString& PluginName);
+
+	/** Rebuild the cue library now if any paths have changed since the last rebuild. */
+	void FlushCueLibraryRebuild();
+
+protected:
+	/** Handle to the ticker that will rebuild the cue library at the end of the frame. */
+	FTSTicker::FDelegateHandle RebuildTickerHandle;
+
+	/** The cues added incrementally for each plugin, by plugin URL. */
+	TMap<FString, TArray<FSoftObjectPath>> PluginCueRefs;
+
+	/** Gather the gameplay cue paths of all AddGameplayCuePaths actions in a game feature. */
+	TArray<FString> GetGameplayCuePaths(const UGameFeatureData* GameFeatureData, const FString& PluginName);
+
+	/** Find all gameplay cue notifies in the given paths. */
+	static void FindGameplayCues(const TArray<FString>& CuePaths, TArray<struct FGameplayCueReferencePair>& OutCues);
+
+	/** Schedule a rebuild of the cue library for the next ticker update. */
+	void RequestCueLibraryRebuild();
+
+	bool OnRebuildTick(float DeltaTime);
 };
@@ -10,6 +10,7 @@
 
 class AHUD;
 class UCommonActivatableWidget;
+class UGameFeatureWidgetPoolSubsystem;
 
 
 USTRUCT(BlueprintType)
@@ -68,6 +69,14 @@ public:
 	UPROPERTY(EditAnywhere, Meta = (TitleProperty = "{ExtensionPoint} -> {WidgetClass}"), Category = "UI")
 	TArray<FGameFeatureExtensionWidgetEntry> Widgets;
 
+	/**
+	 * Keep layout widgets when they are removed, e.g. when the HUD is destroyed, and reuse them
+	 * the next time they are added to the same layer for the same local player instead of creating new ones.
+	 * Extension point widgets inside pooled layouts keep their own pooled entry widgets as well.
+	 */
+	UPROPERTY(EditAnywhere, Category = "UI")
+	bool bPoolLayoutWidgets = false;
+
 protected:
 	struct FActorHandlesData
 	{
@@ -83,6 +92,9 @@ protected:
 		/** Per-actor data about added widgets. */
 		TMap<FObjectKey, FActorHandlesData> ActorData;
 
+		/** The world's pool that removed layout widgets are returned to, when pooling. */
+		TWeakObjectPtr<UGameFeatureWidgetPoolSubsystem> WidgetPool;
+
 		virtual bool IsEmpty() const override
 		{
 			return FContextHandles::IsEmpty() && ActorData.IsEmpty();
@@ -100,4 +112,8 @@ protected:
 	virtual void AddWidgets(AActor* Actor, FWidgetContextHandles& Handles);
 
 	virtual void RemoveWidgets(AActor* Actor, FWidgetContextHandles& Handles);
+
+	/** Add a pooled layout widget to a layer, creating it if none is available. */
+	UCommonActivatableWidget* AddPooledLayoutWidget(ULocalPlayer* LocalPlayer, const FGameplayTag& Layer,
+	                                                TSubclassOf<UCommonActivatableWidget> WidgetClass, FWidgetContextHandles& Handles);
 };
@@ -0,0 +1,64 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameFeatureWidgetPoolSubsystem.generated.h"
+
+class UCommonActivatableWidget;
+class UCommonActivatableWidgetContainerBase;
+
+
+/** A removed layout widget that can be added again to the same layer. */
+USTRUCT()
+struct FGameFeaturePooledLayoutWidget
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+	TObjectPtr<UCommonActivatableWidget> Widget;
+
+	/** The layer the widget was created in, and may be added to again. */
+	TWeakObjectPtr<UCommonActivatableWidgetContainerBase> Layer;
+
+	/** The local player the widget was created for. */
+	TWeakObjectPtr<ULocalPlayer> LocalPlayer;
+
+	/** The object that returned the widget to the pool. */
+	TWeakObjectPtr<const UObject> Owner;
+};
+
+
+/**
+ * Holds layout widgets removed by game feature actions so they can be reused,
+ * e.g. when the HUD is destroyed and re-created. Pooled widgets never outlive the world,
+ * and are dropped as soon as their layer no longer belongs to the player's current root layout.
+ */
+UCLASS()
+class EXTENDEDGAMEFEATUREACTIONS_API UGameFeatureWidgetPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Take a pooled widget of a class that was previously removed from a layer, or null if none is available. */
+	UCommonActivatableWidget* AcquireLayoutWidget(const ULocalPlayer* LocalPlayer, const UCommonActivatableWidgetContainerBase* Layer,
+	                                              TSubclassOf<UCommonActivatableWidget> WidgetClass);
+
+	/** Return a removed layout widget to the pool. The widget must have been created in its layer. */
+	void ReleaseLayoutWidget(UCommonActivatableWidget* Widget, const UObject* Owner);
+
+	/** Drop all pooled widgets that were returned by an owner. */
+	void RemoveLayoutWidgets(const UObject* Owner);
+
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Drop pooled widgets whose player or layer is gone, or whose layer was replaced with a new root layout. */
+	void PruneLayoutWidgets();
+
+	UPROPERTY(Transient)
+	TArray<FGameFeaturePooledLayoutWidget> PooledLayoutWidgets;
+};
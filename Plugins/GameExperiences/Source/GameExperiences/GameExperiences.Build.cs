@@ -20,7 +20,10 @@ public class GameExperiences : ModuleRules
 		{
 			"CoreUObject",
 			"Engine",
+			"Json",
+			"JsonUtilities",
 			"NetCore",
+			"Projects",
 			"Slate",
 			"SlateCore",
 		});
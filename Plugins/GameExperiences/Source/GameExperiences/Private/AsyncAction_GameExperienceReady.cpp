@@ -48,7 +48,7 @@ void UAsyncAction_GameExperienceReady::OnGameStateAvailable(AGameStateBase* Game
 		World->GameStateSetEvent.RemoveAll(this);
 	}
 
-	UGameExperienceComponent* ExperienceComponent = GameState->FindComponentByClass<UGameExperienceComponent>();
+	UGameExperienceComponent* ExperienceComponent = UGameExperienceComponent::Get(GameState);
 	if (!ExperienceComponent)
 	{
 		// experience component is not available
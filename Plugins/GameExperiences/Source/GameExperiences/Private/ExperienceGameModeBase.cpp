@@ -4,13 +4,18 @@
 #include "ExperienceGameModeBase.h"
 
 #include "GameExperienceComponent.h"
+#include "GameExperiencePlayerComponent.h"
 #include "GameExperiencesModule.h"
 #include "TimerManager.h"
+#include "Algo/StableSort.h"
+#include "GameFramework/PlayerState.h"
 
 
 AExperienceGameModeBase::AExperienceGameModeBase(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, bRestartPlayersOnExperienceLoad(true)
+	, MaxPlayerRestartsPerFrame(0)
+	, PlayerRestartBudgetMs(0.f)
 {
 }
 
@@ -23,7 +28,7 @@ FPrimaryAssetId AExperienceGameModeBase::GetDesiredGameExperience(FString& OutDe
 
 UGameExperienceComponent* AExperienceGameModeBase::GetExperienceComponent() const
 {
-	return GameState->FindComponentByClass<UGameExperienceComponent>();
+	return UGameExperienceComponent::Get(this);
 }
 
 bool AExperienceGameModeBase::IsExperienceLoaded() const
@@ -79,11 +84,41 @@ void AExperienceGameModeBase::InitGameExperience()
 
 bool AExperienceGameModeBase::IsPlayerExperienceLoaded(APlayerController* Player) const
 {
-	// implement in subclass if you want to block players
-	// from restarting until their client experience has finished loading
+	// players without a player component can't report their load state, so don't block them
+	if (const UGameExperiencePlayerComponent* PlayerComponent = UGameExperiencePlayerComponent::FindForController(Player))
+	{
+		return PlayerComponent->IsClientExperienceLoaded();
+	}
 	return true;
 }
 
+void AExperienceGameModeBase::OnPlayerExperienceLoaded(APlayerController* Player)
+{
+	if (!bRestartPlayersOnExperienceLoad || !Player || Player->GetPawn() || !IsExperienceLoaded())
+	{
+		// restarted later when the experience loads
+		return;
+	}
+
+	if (!PlayerCanRestart(Player))
+	{
+		return;
+	}
+
+	// queue instead of restarting now, so that clients finishing in the same frame are spread out by the frame budget
+	if (PlayerRestartQueueIndex >= PlayerRestartQueue.Num())
+	{
+		PlayerRestartQueue.Reset();
+		PlayerRestartQueueIndex = 0;
+		NumQueuedPlayersRestarted = 0;
+		NumPlayerRestartFrames = 0;
+		PlayerRestartStartTime = FPlatformTime::Seconds();
+	}
+	PlayerRestartQueue.AddUnique(Player);
+
+	SchedulePlayerRestartQueue();
+}
+
 void AExperienceGameModeBase::OnExperienceLoaded(const UGameExperienceDef* Experience)
 {
 	if (!bRestartPlayersOnExperienceLoad)
@@ -91,16 +126,80 @@ void AExperienceGameModeBase::OnExperienceLoaded(const UGameExperienceDef* Exper
 		return;
 	}
 
-	// restart players
-	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	// queue players, humans first
+	PlayerRestartQueue.Reset();
+	PlayerRestartQueueIndex = 0;
+	NumQueuedPlayersRestarted = 0;
+	NumPlayerRestartFrames = 0;
+	PlayerRestartStartTime = FPlatformTime::Seconds();
+
+	// include bots, i.e. AI controllers that have a player state
+	for (FConstControllerIterator Iterator = GetWorld()->GetControllerIterator(); Iterator; ++Iterator)
 	{
-		APlayerController* PC = Cast<APlayerController>(*Iterator);
-		if (PC && PC->GetPawn() == nullptr)
+		AController* Controller = Iterator->Get();
+		if (Controller && (Controller->IsA<APlayerController>() || Controller->PlayerState))
 		{
-			if (PlayerCanRestart(PC))
-			{
-				RestartPlayer(PC);
-			}
+			PlayerRestartQueue.Add(Controller);
 		}
 	}
+
+	Algo::StableSortBy(PlayerRestartQueue, [](const TWeakObjectPtr<AController>& Controller)
+	{
+		return Controller->PlayerState && Controller->PlayerState->IsABot();
+	});
+
+	ProcessPlayerRestartQueue();
+}
+
+bool AExperienceGameModeBase::ControllerCanRestart(AController* Controller)
+{
+	if (APlayerController* Player = Cast<APlayerController>(Controller))
+	{
+		return PlayerCanRestart(Player);
+	}
+
+	return Controller && !Controller->IsPendingKillPending() && IsExperienceLoaded();
+}
+
+void AExperienceGameModeBase::ProcessPlayerRestartQueue()
+{
+	++NumPlayerRestartFrames;
+
+	const double FrameStartTime = FPlatformTime::Seconds();
+	int32 NumRestartedThisFrame = 0;
+
+	while (PlayerRestartQueueIndex < PlayerRestartQueue.Num())
+	{
+		if ((MaxPlayerRestartsPerFrame > 0 && NumRestartedThisFrame >= MaxPlayerRestartsPerFrame) ||
+			(PlayerRestartBudgetMs > 0.f && (FPlatformTime::Seconds() - FrameStartTime) * 1000.0 >= PlayerRestartBudgetMs))
+		{
+			// continue next frame
+			SchedulePlayerRestartQueue();
+			return;
+		}
+
+		// players may have left, or already been restarted by other means while waiting
+		AController* Controller = PlayerRestartQueue[PlayerRestartQueueIndex++].Get();
+		if (Controller && Controller->GetPawn() == nullptr && ControllerCanRestart(Controller))
+		{
+			RestartPlayer(Controller);
+			++NumRestartedThisFrame;
+			++NumQueuedPlayersRestarted;
+		}
+	}
+
+	UE_LOG(LogGameExperience, Log, TEXT("Restarted %d players in %.2f ms over %d frame(s)"),
+		NumQueuedPlayersRestarted, (FPlatformTime::Seconds() - PlayerRestartStartTime) * 1000.0, NumPlayerRestartFrames);
+
+	PlayerRestartQueue.Reset();
+	PlayerRestartQueueIndex = 0;
+}
+
+void AExperienceGameModeBase::SchedulePlayerRestartQueue()
+{
+	FTimerManager& TimerManager = GetWorldTimerManager();
+	if (!TimerManager.TimerExists(PlayerRestartTimerHandle))
+	{
+		PlayerRestartTimerHandle = TimerManager.SetTimerForNextTick(this, &ThisClass::ProcessPlayerRestartQueue);
+	}
 }
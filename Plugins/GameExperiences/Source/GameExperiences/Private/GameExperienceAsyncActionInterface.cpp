@@ -0,0 +1,4 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+
+#include "GameExperienceAsyncActionInterface.h"
@@ -4,9 +4,12 @@
 #include "GameExperienceComponent.h"
 
 #include "GameExperienceActionSet.h"
+#include "GameExperienceAsyncActionInterface.h"
+#include "GameExperienceEngineSubsystem.h"
 #include "GameExperienceExternalFeatureInterface.h"
 #include "GameExperiencesModule.h"
 #include "GameExperienceWorldSettings.h"
+#include "GameExperienceWorldSubsystem.h"
 #include "GameFeatureAction.h"
 #include "GameFeaturesSubsystem.h"
 #include "GameFeaturesSubsystemSettings.h"
@@ -17,6 +20,11 @@
 #include "Misc/CommandLine.h"
 #include "Net/UnrealNetwork.h"
 #include "Net/Core/PushModel/PushModel.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+
+CSV_DEFINE_CATEGORY(GameExperience, true);
 
 
 TAutoConsoleVariable CVarGameExperienceDebugLoadDelay(
@@ -29,6 +37,17 @@ TAutoConsoleVariable CVarGameExperienceDebugLoadRandomDelay(
 	0.f,
 	TEXT("Delays the load completion of experiences between 0..RandomDelay (in addition to LoadDelay) for debugging."));
 
+TAutoConsoleVariable CVarGameExperiencePipelinedLoad(
+	TEXT("experience.PipelinedLoad"),
+	false,
+	TEXT("Load and activate game feature plugins at the same time as experience asset bundles, instead of after them. ")
+	TEXT("Plugins may then activate before the experience's assets are loaded, so only enable this if no feature depends on them."));
+
+TAutoConsoleVariable CVarGameExperienceExecuteActionsBudgetMs(
+	TEXT("experience.ExecuteActionsBudgetMs"),
+	0.f,
+	TEXT("The max time in milliseconds to spend executing experience actions each frame. 0 executes all actions at once."));
+
 
 /** Return the total delay to apply to experience loading for debugging. */
 float GetGameExperienceDebugLoadDelay()
@@ -59,10 +78,99 @@ namespace GameExperiences
 		}
 		return FString();
 	}
+
+	/**
+	 * Log the change in used memory since an experience started deactivating.
+	 * Released bundles and plugin content are only freed by garbage collection, so this waits for the next one.
+	 */
+	void LogUnloadMemoryDelta(const FString& DebugPrefix, const FString& ExperienceName, uint64 UsedPhysicalBefore)
+	{
+		const TSharedRef<FDelegateHandle> PostGCHandle = MakeShared<FDelegateHandle>();
+		*PostGCHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddLambda([PostGCHandle, DebugPrefix, ExperienceName, UsedPhysicalBefore]()
+		{
+			const uint64 UsedPhysicalAfter = FPlatformMemory::GetStats().UsedPhysical;
+			const double DeltaMB = (static_cast<double>(UsedPhysicalAfter) - static_cast<double>(UsedPhysicalBefore)) / (1024.0 * 1024.0);
+
+			UE_LOG(LogGameExperience, Log, TEXT("%s[%s] Game experience unloaded, used physical memory: %+.2f MB (after garbage collection)"),
+				*DebugPrefix, *ExperienceName, DeltaMB);
+
+			// only report once. this destroys the lambda, so nothing captured can be used afterward
+			const FDelegateHandle Handle = *PostGCHandle;
+			FCoreUObjectDelegates::GetPostGarbageCollect().Remove(Handle);
+		});
+	}
+
+	void DumpLoadStats(UWorld* World)
+	{
+		if (const UGameExperienceComponent* ExperienceComponent = UGameExperienceComponent::Get(World))
+		{
+			const UGameExperienceDef* Experience = ExperienceComponent->GetExperience();
+			ExperienceComponent->GetLoadStats().Log(GetNetDebugPrefix(ExperienceComponent),
+				Experience ? Experience->GetPrimaryAssetId().PrimaryAssetName.ToString() : FString());
+		}
+	}
+}
+
+
+FAutoConsoleCommandWithWorld CmdGameExperienceDumpLoadStats(
+	TEXT("experience.DumpLoadStats"),
+	TEXT("Log the load timings of the experience in the current world, per load state, plugin, action and external feature."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&GameExperiences::DumpLoadStats));
+
+
+// FGameExperienceLoadStats
+// ------------------------
+
+void FGameExperienceLoadStats::Reset()
+{
+	StartTime = 0.0;
+	TotalDuration = 0.0;
+	StateDurations.Reset();
+	PluginDurations.Reset();
+	ActionDurations.Reset();
+	AsyncActionDurations.Reset();
+	ExternalFeatureDurations.Reset();
+	ExternalFeatureCriticalPath.Reset();
+}
+
+void FGameExperienceLoadStats::Log(const FString& DebugPrefix, const FString& ExperienceName) const
+{
+	UE_LOG(LogGameExperience, Log, TEXT("%s[%s] Load stats, total: %.2f ms"), *DebugPrefix, *ExperienceName, TotalDuration * 1000.0);
+
+	for (const TPair<EGameExperienceLoadState, double>& Elem : StateDurations)
+	{
+		UE_LOG(LogGameExperience, Log, TEXT("  State %s: %.2f ms"),
+			*StaticEnum<EGameExperienceLoadState>()->GetNameStringByValue((uint8)Elem.Key), Elem.Value * 1000.0);
+	}
+	for (const TPair<FString, double>& Elem : PluginDurations)
+	{
+		UE_LOG(LogGameExperience, Log, TEXT("  Plugin %s: %.2f ms"), *Elem.Key, Elem.Value * 1000.0);
+	}
+	for (int32 Idx = 0; Idx < ActionDurations.Num(); ++Idx)
+	{
+		UE_LOG(LogGameExperience, Log, TEXT("  Action %d %s: %.2f ms"), Idx, *ActionDurations[Idx].Key, ActionDurations[Idx].Value * 1000.0);
+	}
+	for (const TPair<FString, double>& Elem : AsyncActionDurations)
+	{
+		UE_LOG(LogGameExperience, Log, TEXT("  Async action %s: %.2f ms"), *Elem.Key, Elem.Value * 1000.0);
+	}
+	for (const TPair<FString, double>& Elem : ExternalFeatureDurations)
+	{
+		UE_LOG(LogGameExperience, Log, TEXT("  External feature %s: %.2f ms"), *Elem.Key, Elem.Value * 1000.0);
+	}
+	if (!ExternalFeatureCriticalPath.IsEmpty())
+	{
+		UE_LOG(LogGameExperience, Log, TEXT("  External feature critical path: %s"), *FString::Join(ExternalFeatureCriticalPath, TEXT(" -> ")));
+	}
 }
 
 
+// UGameExperienceComponent
+// ------------------------
+
+
 UGameExperienceComponent::FLoadingDelegate UGameExperienceComponent::OnExperienceLoadingEvent;
+UGameExperienceComponent::FLoadStateChangedDelegate UGameExperienceComponent::OnExperienceLoadStateChangedEvent;
 
 
 UGameExperienceComponent::UGameExperienceComponent(const FObjectInitializer& ObjectInitializer)
@@ -81,6 +189,33 @@ void UGameExperienceComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProper
 	DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, Experience, Params);
 }
 
+UGameExperienceComponent* UGameExperienceComponent::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	const UGameExperienceWorldSubsystem* WorldSubsystem = World ? World->GetSubsystem<UGameExperienceWorldSubsystem>() : nullptr;
+	return WorldSubsystem ? WorldSubsystem->GetExperienceComponent() : nullptr;
+}
+
+void UGameExperienceComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	if (UGameExperienceWorldSubsystem* WorldSubsystem = GetWorld()->GetSubsystem<UGameExperienceWorldSubsystem>())
+	{
+		WorldSubsystem->RegisterExperienceComponent(this);
+	}
+}
+
+void UGameExperienceComponent::OnUnregister()
+{
+	if (UGameExperienceWorldSubsystem* WorldSubsystem = GetWorld()->GetSubsystem<UGameExperienceWorldSubsystem>())
+	{
+		WorldSubsystem->UnregisterExperienceComponent(this);
+	}
+
+	Super::OnUnregister();
+}
+
 void UGameExperienceComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
@@ -164,10 +299,53 @@ void UGameExperienceComponent::AutoResolveExperience()
 
 void UGameExperienceComponent::SetExperience(const FPrimaryAssetId& ExperienceId)
 {
-	const UAssetManager& AssetManager = UAssetManager::Get();
+	check(LoadState == EGameExperienceLoadState::Unloaded);
+
+	UAssetManager& AssetManager = UAssetManager::Get();
 	const FSoftObjectPath AssetPath = AssetManager.GetPrimaryAssetPath(ExperienceId);
-	const TSubclassOf<UGameExperienceDef> ExperienceClass = Cast<UClass>(AssetPath.TryLoad());
+	if (AssetPath.IsNull())
+	{
+		UE_LOG(LogGameExperience, Error, TEXT("%sCould not find GameExperience '%s'"),
+			*GameExperiences::GetNetDebugPrefix(this), *ExperienceId.ToString());
+		return;
+	}
+
+	PendingExperienceId = ExperienceId;
+	SetLoadState(EGameExperienceLoadState::LoadingDefinition);
+
+	// stream in the experience class instead of blocking the game thread,
+	// the delegate may be called immediately if the class is already loaded
+	ExperienceDefLoadHandle = AssetManager.GetStreamableManager().RequestAsyncLoad(
+		AssetPath, FStreamableDelegate::CreateUObject(this, &ThisClass::OnExperienceDefLoaded), FStreamableManager::AsyncLoadHighPriority);
 
+	if (LoadState != EGameExperienceLoadState::LoadingDefinition)
+	{
+		// the class was already loaded and has been handled
+		ExperienceDefLoadHandle.Reset();
+	}
+}
+
+void UGameExperienceComponent::OnExperienceDefLoaded()
+{
+	if (LoadState != EGameExperienceLoadState::LoadingDefinition)
+	{
+		// the load was canceled
+		return;
+	}
+
+	ExperienceDefLoadHandle.Reset();
+
+	const FSoftObjectPath AssetPath = UAssetManager::Get().GetPrimaryAssetPath(PendingExperienceId);
+	const TSubclassOf<UGameExperienceDef> ExperienceClass = Cast<UClass>(AssetPath.ResolveObject());
+	if (!ExperienceClass)
+	{
+		UE_LOG(LogGameExperience, Error, TEXT("%sFailed to load GameExperience '%s'"),
+			*GameExperiences::GetNetDebugPrefix(this), *PendingExperienceId.ToString());
+		SetLoadState(EGameExperienceLoadState::Unloaded);
+		return;
+	}
+
+	// only replicate the experience once its class is in memory
 	Experience = ExperienceClass->GetDefaultObject<UGameExperienceDef>();
 	MARK_PROPERTY_DIRTY_FROM_NAME(ThisClass, Experience, this);
 	check(Experience);
@@ -175,6 +353,242 @@ void UGameExperienceComponent::SetExperience(const FPrimaryAssetId& ExperienceId
 	LoadExperience();
 }
 
+void UGameExperienceComponent::SwitchExperience(const FPrimaryAssetId& ExperienceId)
+{
+	if (LoadState == EGameExperienceLoadState::Unloaded)
+	{
+		SetExperience(ExperienceId);
+		return;
+	}
+
+	if (!GetOwner()->HasAuthority())
+	{
+		UE_LOG(LogGameExperience, Error, TEXT("%sSwitchExperience can only be called on the server"),
+			*GameExperiences::GetNetDebugPrefix(this));
+		return;
+	}
+
+	UAssetManager& AssetManager = UAssetManager::Get();
+	const FSoftObjectPath AssetPath = AssetManager.GetPrimaryAssetPath(ExperienceId);
+	if (AssetPath.IsNull())
+	{
+		UE_LOG(LogGameExperience, Error, TEXT("%sCould not find GameExperience '%s'"),
+			*GameExperiences::GetNetDebugPrefix(this), *ExperienceId.ToString());
+		return;
+	}
+
+	UE_LOG(LogGameExperience, Log, TEXT("%sSwitching to GameExperience '%s'"),
+		*GameExperiences::GetNetDebugPrefix(this), *ExperienceId.ToString());
+
+	// replace any switch that is still loading its definition
+	if (SwitchExperienceDefLoadHandle.IsValid())
+	{
+		SwitchExperienceDefLoadHandle->CancelHandle();
+		SwitchExperienceDefLoadHandle.Reset();
+	}
+
+	PendingSwitchExperienceId = ExperienceId;
+
+	const TSharedPtr<FStreamableHandle> LoadHandle = AssetManager.GetStreamableManager().RequestAsyncLoad(
+		AssetPath, FStreamableDelegate::CreateUObject(this, &ThisClass::OnSwitchExperienceDefLoaded, ExperienceId),
+		FStreamableManager::AsyncLoadHighPriority);
+
+	if (PendingSwitchExperienceId == ExperienceId && LoadHandle.IsValid() && !LoadHandle->HasLoadCompleted())
+	{
+		SwitchExperienceDefLoadHandle = LoadHandle;
+	}
+}
+
+void UGameExperienceComponent::OnSwitchExperienceDefLoaded(FPrimaryAssetId ExperienceId)
+{
+	if (ExperienceId != PendingSwitchExperienceId ||
+		LoadState == EGameExperienceLoadState::Unloaded ||
+		(LoadState == EGameExperienceLoadState::Deactivating && !bSwitchingExperience))
+	{
+		// replaced by another switch, or deactivated
+		return;
+	}
+
+	SwitchExperienceDefLoadHandle.Reset();
+
+	const FSoftObjectPath AssetPath = UAssetManager::Get().GetPrimaryAssetPath(ExperienceId);
+	const TSubclassOf<UGameExperienceDef> ExperienceClass = Cast<UClass>(AssetPath.ResolveObject());
+	if (!ExperienceClass)
+	{
+		UE_LOG(LogGameExperience, Error, TEXT("%sFailed to load GameExperience '%s'"),
+			*GameExperiences::GetNetDebugPrefix(this), *ExperienceId.ToString());
+		return;
+	}
+
+	RequestSwitchExperience(ExperienceClass->GetDefaultObject<UGameExperienceDef>());
+}
+
+void UGameExperienceComponent::RequestSwitchExperience(UGameExperienceDef* NewExperience)
+{
+	if (LoadState == EGameExperienceLoadState::Failed && NewExperience)
+	{
+		// a failed experience can't be switched in place, so deactivate it fully and load the new one afterward
+		UE_LOG(LogGameExperience, Log, TEXT("%sReplacing failed GameExperience with '%s'"),
+			*GameExperiences::GetNetDebugPrefix(this), *NewExperience->GetPrimaryAssetId().ToString());
+
+		DeactivateExperience();
+		PendingSwitchExperience = NewExperience;
+		if (LoadState == EGameExperienceLoadState::Unloaded)
+		{
+			// deactivated immediately
+			LoadPendingSwitchExperience();
+		}
+		return;
+	}
+
+	if (LoadState != EGameExperienceLoadState::Loaded)
+	{
+		// switching back to the current experience cancels any pending switch
+		PendingSwitchExperience = NewExperience != Experience ? NewExperience : nullptr;
+		return;
+	}
+
+	PendingSwitchExperience = nullptr;
+
+	if (NewExperience && NewExperience != Experience)
+	{
+		SwitchToExperience(NewExperience);
+	}
+}
+
+void UGameExperienceComponent::SwitchToExperience(UGameExperienceDef* NewExperience)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(UGameExperienceComponent::SwitchToExperience, GameExperienceChannel);
+
+	check(LoadState == EGameExperienceLoadState::Loaded);
+	check(NewExperience);
+
+	UE_LOG(LogGameExperience, Verbose, TEXT("%s[%s] Switching to game experience %s"),
+		*GameExperiences::GetNetDebugPrefix(this),
+		*Experience->GetPrimaryAssetId().PrimaryAssetName.ToString(),
+		*NewExperience->GetPrimaryAssetId().PrimaryAssetName.ToString());
+
+	bSwitchingExperience = true;
+	SetLoadState(EGameExperienceLoadState::Deactivating);
+
+	// the switch is timed as a new load
+	LoadStats.Reset();
+	LoadStats.StartTime = FPlatformTime::Seconds();
+
+	// memory freed by the switch is reported for the outgoing experience
+	DeactivateUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+	DeactivatingExperienceName = Experience->GetPrimaryAssetId().PrimaryAssetName.ToString();
+
+	Experience = NewExperience;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ThisClass, Experience, this);
+
+	// find the actions of action sets that are not part of the new experience
+	TSet<const UGameFeatureAction*> ActionsToDeactivate;
+	for (int32 Idx = ActiveActionSets.Num() - 1; Idx >= 0; --Idx)
+	{
+		UGameExperienceActionSet* ActionSet = ActiveActionSets[Idx];
+		if (ActionSet && Experience->ActionSets.Contains(ActionSet))
+		{
+			continue;
+		}
+
+		if (ActionSet)
+		{
+			for (const UGameFeatureAction* Action : ActionSet->Actions)
+			{
+				ActionsToDeactivate.Add(Action);
+			}
+		}
+		ActiveActionSets.RemoveAt(Idx);
+	}
+
+	NumExpectedPausers = INDEX_NONE;
+	NumPausers = 0;
+
+	FGameFeatureDeactivatingContext Context(TEXT(""), [this, Serial = ++ActionDeactivationSerial](FStringView InPauserTag)
+		{
+			if (Serial == ActionDeactivationSerial)
+			{
+				OnActionDeactivationCompleted();
+			}
+		});
+
+	if (const FWorldContext* WorldContext = GEngine->GetWorldContextFromWorld(GetWorld()))
+	{
+		Context.SetRequiredWorldContextHandle(WorldContext->ContextHandle);
+	}
+
+	// deactivate them, keeping shared actions active
+	for (int32 Idx = 0; Idx < NumExecutedActions; ++Idx)
+	{
+		UGameFeatureAction* Action = QueuedActions[Idx].Get();
+		if (Action && ActionsToDeactivate.Contains(Action))
+		{
+			Action->OnGameFeatureDeactivating(Context);
+			Action->OnGameFeatureUnregistering();
+		}
+	}
+
+	QueuedActions.RemoveAll([&ActionsToDeactivate](const TWeakObjectPtr<UGameFeatureAction>& Action)
+	{
+		return !Action.IsValid() || ActionsToDeactivate.Contains(Action.Get());
+	});
+	NumExecutedActions = QueuedActions.Num();
+
+	NumExpectedPausers = Context.GetNumPausers();
+
+	if (NumExpectedPausers == NumPausers)
+	{
+		OnSwitchActionsDeactivated();
+	}
+}
+
+void UGameExperienceComponent::OnSwitchActionsDeactivated()
+{
+	bSwitchingExperience = false;
+
+	ExperienceManifest = GetExperienceManifest();
+
+	// release plugins that the new experience doesn't use
+	UGameExperienceEngineSubsystem* EngineSubsystem = UGameExperienceEngineSubsystem::Get();
+	TArray<FString> NewPluginURLs;
+	for (const FString& PluginName : ExperienceManifest.GameFeatures)
+	{
+		FString PluginURL;
+		if (EngineSubsystem->FindGameFeaturePluginURL(PluginName, PluginURL))
+		{
+			NewPluginURLs.Add(PluginURL);
+		}
+	}
+
+	TArray<FString> RemovedPluginURLs;
+	for (const FString& PluginURL : GameFeaturePluginURLs)
+	{
+		if (!NewPluginURLs.Contains(PluginURL))
+		{
+			RemovedPluginURLs.Add(PluginURL);
+		}
+	}
+	GameFeaturePluginURLs.RemoveAll([&RemovedPluginURLs](const FString& PluginURL) { return RemovedPluginURLs.Contains(PluginURL); });
+	ReleaseGameFeaturePlugins(RemovedPluginURLs);
+
+	// release bundles that the new experience doesn't use
+	TArray<FPrimaryAssetId> RemovedAssetIds;
+	for (const FPrimaryAssetId& AssetId : BundleAssetIds)
+	{
+		if (!ExperienceManifest.BundleAssetIds.Contains(AssetId))
+		{
+			RemovedAssetIds.Add(AssetId);
+		}
+	}
+	UGameExperienceEngineSubsystem::Get()->ReleaseAssetBundles(this, RemovedAssetIds);
+	BundleAssetIds.RemoveAll([&RemovedAssetIds](const FPrimaryAssetId& AssetId) { return RemovedAssetIds.Contains(AssetId); });
+	BundleLoadHandle.Reset();
+
+	// load the rest like any other experience, skipping everything that is still active
+	LoadExperience();
+}
+
 bool UGameExperienceComponent::IsExperienceLoaded() const
 {
 	return Experience && LoadState == EGameExperienceLoadState::Loaded;
@@ -204,24 +618,68 @@ void UGameExperienceComponent::CallOrRegisterOnExperienceLoaded(FOnGameExperienc
 	}
 }
 
-void UGameExperienceComponent::OnRep_Experience()
+void UGameExperienceComponent::OnRep_Experience(UGameExperienceDef* OldExperience)
 {
-	LoadExperience();
+	if (LoadState == EGameExperienceLoadState::Unloaded)
+	{
+		if (Experience)
+		{
+			LoadExperience();
+		}
+		return;
+	}
+
+	if (!Experience)
+	{
+		// the server deactivated its experience
+		Experience = OldExperience;
+		DeactivateExperience();
+		return;
+	}
+
+	// the server switched experiences. keep the current one until it's safe to switch,
+	// since the rest of the load pipeline reads from it
+	UGameExperienceDef* NewExperience = Experience;
+	Experience = OldExperience;
+	RequestSwitchExperience(NewExperience);
 }
 
 void UGameExperienceComponent::SetLoadState(EGameExperienceLoadState NewLoadState)
 {
+	const double Now = FPlatformTime::Seconds();
+	if (LoadState == EGameExperienceLoadState::Unloaded)
+	{
+		// starting a new load
+		LoadStats.Reset();
+		LoadStats.StartTime = Now;
+	}
+	else if (LoadState != EGameExperienceLoadState::Loaded &&
+		LoadState != EGameExperienceLoadState::Deactivating &&
+		LoadState != EGameExperienceLoadState::Failed)
+	{
+		LoadStats.StateDurations.FindOrAdd(LoadState) += Now - LoadStateStartTime;
+	}
+	LoadStateStartTime = Now;
+
 	LoadState = NewLoadState;
 
+	TRACE_BOOKMARK(TEXT("GameExperience LoadState: %s"), *StaticEnum<EGameExperienceLoadState>()->GetNameStringByValue((uint8)NewLoadState));
+
 	UE_LOG(LogGameExperience, Verbose, TEXT("%s[%s] LoadState: %s"),
 		*GameExperiences::GetNetDebugPrefix(this),
-		*Experience->GetPrimaryAssetId().PrimaryAssetName.ToString(),
+		*(Experience ? Experience->GetPrimaryAssetId() : PendingExperienceId).PrimaryAssetName.ToString(),
 		*StaticEnum<EGameExperienceLoadState>()->GetNameStringByValue((uint8)NewLoadState));
+
+	OnExperienceLoadStateChangedEvent.Broadcast(this, NewLoadState);
 }
 
 void UGameExperienceComponent::LoadExperience()
 {
-	check(LoadState == EGameExperienceLoadState::Unloaded);
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(UGameExperienceComponent::LoadExperience, GameExperienceChannel);
+
+	check(LoadState == EGameExperienceLoadState::Unloaded ||
+		LoadState == EGameExperienceLoadState::LoadingDefinition ||
+		LoadState == EGameExperienceLoadState::Deactivating);
 	check(Experience);
 
 	SetLoadState(EGameExperienceLoadState::Loading);
@@ -229,6 +687,19 @@ void UGameExperienceComponent::LoadExperience()
 	// broadcast _static_ delegate
 	OnExperienceLoadingEvent.Broadcast(this, Experience);
 
+	// use the dependencies gathered during cook when available
+	ExperienceManifest = GetExperienceManifest();
+
+	bExperienceAssetsLoaded = false;
+	bGameFeaturePluginsRequested = false;
+
+	// plugins are known as soon as the definition is loaded, so they can load alongside the asset bundles.
+	// actions are not executed until both have finished
+	if (CVarGameExperiencePipelinedLoad.GetValueOnGameThread())
+	{
+		LoadGameFeaturePlugins();
+	}
+
 	// determine whether to load client/server bundles
 	TArray<FName> BundlesToLoad;
 	const ENetMode OwnerNetMode = GetOwner()->GetNetMode();
@@ -241,88 +712,130 @@ void UGameExperienceComponent::LoadExperience()
 		BundlesToLoad.Add(UGameFeaturesSubsystemSettings::LoadStateServer);
 	}
 
-	// gather list of data assets for which to load bundles
-	TSet<FPrimaryAssetId> BundleAssetList;
-	BundleAssetList.Add(Experience->GetPrimaryAssetId());
-	for (const UGameExperienceActionSet* ActionSet : Experience->ActionSets)
+	// start bundle load. bundles are shared with other experiences in this process,
+	// so assets that are still loaded or loading for another world are not requested again.
+	// assets kept from before a switch are already referenced by this component
+	TArray<FPrimaryAssetId> AssetIdsToRequest;
+	for (const FPrimaryAssetId& AssetId : ExperienceManifest.BundleAssetIds)
 	{
-		if (ActionSet)
+		if (!BundleAssetIds.Contains(AssetId))
 		{
-			BundleAssetList.Add(ActionSet->GetPrimaryAssetId());
+			AssetIdsToRequest.Add(AssetId);
 		}
 	}
+	BundleAssetIds.Append(AssetIdsToRequest);
+	BundleLoadHandle = UGameExperienceEngineSubsystem::Get()->RequestAssetBundles(this, AssetIdsToRequest, BundlesToLoad);
 
-	// start bundle load
-	UAssetManager& AssetManager = UAssetManager::Get();
-
-	const FStreamableDelegate BundleLoadDelegate = FStreamableDelegate::CreateUObject(this, &ThisClass::OnExperienceAssetsLoaded);
-
-	const TSharedPtr<FStreamableHandle> LoadHandle = AssetManager.ChangeBundleStateForPrimaryAssets(
-		BundleAssetList.Array(), BundlesToLoad, {}, false, BundleLoadDelegate, FStreamableManager::AsyncLoadHighPriority);
-
-	if (LoadHandle.IsValid() && !LoadHandle->HasLoadCompleted())
+	if (BundleLoadHandle.IsValid())
 	{
+		const FStreamableDelegate BundleLoadDelegate = FStreamableDelegate::CreateUObject(this, &ThisClass::OnExperienceAssetsLoaded);
+		BundleLoadHandle->BindCompleteDelegate(BundleLoadDelegate);
+
 		// ensure delegate is called even when load is canceled
-		LoadHandle->BindCancelDelegate(FStreamableDelegate::CreateLambda([BundleLoadDelegate]
-			{
-				BundleLoadDelegate.ExecuteIfBound();
-			}));
+		BundleLoadHandle->BindCancelDelegate(BundleLoadDelegate);
+	}
+	else
+	{
+		OnExperienceAssetsLoaded();
 	}
 }
 
-void UGameExperienceComponent::OnExperienceAssetsLoaded()
+FGameExperienceManifest UGameExperienceComponent::GetExperienceManifest() const
 {
-	check(LoadState == EGameExperienceLoadState::Loading);
-
-	LoadGameFeaturePlugins();
+	return Experience->GetManifest();
 }
 
-void UGameExperienceComponent::LoadGameFeaturePlugins()
+void UGameExperienceComponent::OnExperienceAssetsLoaded()
 {
-	check(Experience);
+	if (LoadState != EGameExperienceLoadState::Loading)
+	{
+		// deactivated while loading
+		return;
+	}
 
-	GameFeaturePluginURLs.Reset();
+	bExperienceAssetsLoaded = true;
 
-	for (const UGameExperienceActionSet* ActionSet : Experience->ActionSets)
+	if (!bGameFeaturePluginsRequested)
 	{
-		for (const FString& PluginName : ActionSet->GameFeatures)
-		{
-			FString PluginURL;
-			if (UGameFeaturesSubsystem::Get().GetPluginURLByName(PluginName, PluginURL))
-			{
-				GameFeaturePluginURLs.AddUnique(PluginURL);
-			}
-			else
-			{
-				ensureMsgf(false, TEXT("[%s] [%hs] Couldn't find game feature plugin: %s"),
-					*Experience->GetPrimaryAssetId().PrimaryAssetName.ToString(), __func__, *PluginName);
-			}
-		}
+		LoadGameFeaturePlugins();
 	}
-
-	NumFeaturePluginsLoading = GameFeaturePluginURLs.Num();
-	if (NumFeaturePluginsLoading > 0)
+	else if (NumFeaturePluginsLoading > 0)
 	{
+		// still waiting on plugins that were started with the assets
 		SetLoadState(EGameExperienceLoadState::LoadingGameFeatures);
-
-		for (FString& PluginURL : GameFeaturePluginURLs)
+	}
+	else
+	{
+		OnAllGameFeaturePluginsLoaded();
+	}
+}
+
+void UGameExperienceComponent::LoadGameFeaturePlugins()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(UGameExperienceComponent::LoadGameFeaturePlugins, GameExperienceChannel);
+
+	check(Experience);
+
+	bGameFeaturePluginsRequested = true;
+
+	UGameExperienceEngineSubsystem* EngineSubsystem = UGameExperienceEngineSubsystem::Get();
+
+	// plugin names are already unique in the manifest.
+	// plugins still active from before a switch are already referenced
+	TArray<FString> PluginURLsToLoad;
+	for (const FString& PluginName : ExperienceManifest.GameFeatures)
+	{
+		FString PluginURL;
+		if (EngineSubsystem->FindGameFeaturePluginURL(PluginName, PluginURL))
 		{
-			UGameFeaturesSubsystem::Get().LoadAndActivateGameFeaturePlugin(
-				PluginURL, FGameFeaturePluginLoadComplete::CreateUObject(this, &ThisClass::OnGameFeaturePluginLoaded));
+			if (!GameFeaturePluginURLs.Contains(PluginURL))
+			{
+				GameFeaturePluginURLs.Add(PluginURL);
+				PluginURLsToLoad.Add(PluginURL);
+			}
+		}
+		else
+		{
+			ensureMsgf(false, TEXT("[%s] [%hs] Couldn't find game feature plugin: %s"),
+				*Experience->GetPrimaryAssetId().PrimaryAssetName.ToString(), __func__, *PluginName);
 		}
 	}
-	else
+
+	NumFeaturePluginsLoading = PluginURLsToLoad.Num();
+	if (NumFeaturePluginsLoading > 0)
+	{
+		if (bExperienceAssetsLoaded)
+		{
+			SetLoadState(EGameExperienceLoadState::LoadingGameFeatures);
+		}
+
+		// activate through the engine subsystem so plugins shared with other experiences are reference counted
+		for (const FString& PluginURL : PluginURLsToLoad)
+		{
+			EngineSubsystem->RequestGameFeaturePlugin(
+				PluginURL, FGameFeaturePluginLoadComplete::CreateUObject(this, &ThisClass::OnGameFeaturePluginLoaded, PluginURL));
+		}
+	}
+	else if (bExperienceAssetsLoaded)
 	{
 		OnAllGameFeaturePluginsLoaded();
 	}
 }
 
-void UGameExperienceComponent::OnGameFeaturePluginLoaded(const UE::GameFeatures::FResult& Result)
+void UGameExperienceComponent::OnGameFeaturePluginLoaded(const UE::GameFeatures::FResult& Result, FString PluginURL)
 {
+	if (LoadState == EGameExperienceLoadState::Deactivating || LoadState == EGameExperienceLoadState::Unloaded)
+	{
+		// deactivated while loading
+		return;
+	}
+
+	LoadStats.PluginDurations.Add(PluginURL, FPlatformTime::Seconds() - LoadStats.StartTime);
+
 	--NumFeaturePluginsLoading;
 
-	// continue once all plugins are loaded
-	if (NumFeaturePluginsLoading == 0)
+	// continue once all plugins and assets are loaded
+	if (NumFeaturePluginsLoading == 0 && bExperienceAssetsLoaded)
 	{
 		OnAllGameFeaturePluginsLoaded();
 	}
@@ -330,6 +843,12 @@ void UGameExperienceComponent::OnGameFeaturePluginLoaded(const UE::GameFeatures:
 
 void UGameExperienceComponent::OnAllGameFeaturePluginsLoaded()
 {
+	if (LoadState == EGameExperienceLoadState::Deactivating || LoadState == EGameExperienceLoadState::Unloaded)
+	{
+		// deactivated during the debug delay
+		return;
+	}
+
 	check(LoadState == EGameExperienceLoadState::Loading ||
 		LoadState == EGameExperienceLoadState::LoadingGameFeatures ||
 		LoadState == EGameExperienceLoadState::DebugDelay);
@@ -349,37 +868,126 @@ void UGameExperienceComponent::OnAllGameFeaturePluginsLoaded()
 	}
 
 	ExecuteActions();
-
-	LoadExternalFeatures();
 }
 
 void UGameExperienceComponent::ExecuteActions()
 {
 	SetLoadState(EGameExperienceLoadState::ExecutingActions);
 
-	FGameFeatureActivatingContext Context;
-	if (const FWorldContext* WorldContext = GEngine->GetWorldContextFromWorld(GetWorld()))
-	{
-		Context.SetRequiredWorldContextHandle(WorldContext->ContextHandle);
-	}
+	// queue all actions up front so that execution order stays the same regardless of the frame budget.
+	// actions of action sets that stayed active during a switch are already queued and executed
+	QueuedActions.Reserve(QueuedActions.Num() + ExperienceManifest.NumActions);
+	NumActionsActivating = 0;
+	++ActionActivationSerial;
 
-	for (const UGameExperienceActionSet* ActionSet : Experience->ActionSets)
+	for (UGameExperienceActionSet* ActionSet : Experience->ActionSets)
 	{
-		if (!ActionSet)
+		if (!ActionSet || ActiveActionSets.Contains(ActionSet))
 		{
 			continue;
 		}
+		ActiveActionSets.Add(ActionSet);
+
 		for (UGameFeatureAction* Action : ActionSet->Actions)
 		{
-			if (!Action)
+			if (Action)
 			{
-				continue;
+				QueuedActions.Add(Action);
 			}
+		}
+	}
+
+	ExecuteQueuedActions();
+}
+
+void UGameExperienceComponent::ExecuteQueuedActions()
+{
+	if (LoadState != EGameExperienceLoadState::ExecutingActions)
+	{
+		// deactivated while executing
+		return;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(UGameExperienceComponent::ExecuteQueuedActions, GameExperienceChannel);
+
+	FGameFeatureActivatingContext Context;
+	if (const FWorldContext* WorldContext = GEngine->GetWorldContextFromWorld(GetWorld()))
+	{
+		Context.SetRequiredWorldContextHandle(WorldContext->ContextHandle);
+	}
+
+	const double BudgetSeconds = CVarGameExperienceExecuteActionsBudgetMs.GetValueOnGameThread() * 0.001;
+	const double StartTime = FPlatformTime::Seconds();
+
+	while (NumExecutedActions < QueuedActions.Num())
+	{
+		if (UGameFeatureAction* Action = QueuedActions[NumExecutedActions].Get())
+		{
+			const FString ActionName = Action->GetClass()->GetName();
+			TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(*ActionName, GameExperienceChannel);
+			const double ActionStartTime = FPlatformTime::Seconds();
 
 			Action->OnGameFeatureRegistering();
 			Action->OnGameFeatureLoading();
 			Action->OnGameFeatureActivating(Context);
+
+			if (IGameExperienceAsyncActionInterface* AsyncAction = Cast<IGameExperienceAsyncActionInterface>(Action))
+			{
+				const int32 ActionIndex = NumExecutedActions;
+				const int32 ActivationSerial = ActionActivationSerial;
+
+				++NumActionsActivating;
+				const bool bIsActivating = AsyncAction->ActivateAsync(Context, FSimpleDelegate::CreateWeakLambda(this,
+					[this, ActionIndex, ActionStartTime, ActivationSerial]()
+					{
+						if (ActivationSerial == ActionActivationSerial)
+						{
+							OnAsyncActionActivated(ActionIndex, ActionStartTime);
+						}
+					}));
+
+				if (!bIsActivating)
+				{
+					--NumActionsActivating;
+				}
+			}
+
+			LoadStats.ActionDurations.Emplace(ActionName, FPlatformTime::Seconds() - ActionStartTime);
 		}
+		++NumExecutedActions;
+
+		if (BudgetSeconds > 0.0 && NumExecutedActions < QueuedActions.Num() &&
+			FPlatformTime::Seconds() - StartTime >= BudgetSeconds)
+		{
+			// out of time, continue next frame
+			GetWorldTimerManager().SetTimerForNextTick(this, &ThisClass::ExecuteQueuedActions);
+			return;
+		}
+	}
+
+	// otherwise continue once the last async action has activated
+	if (NumActionsActivating == 0)
+	{
+		LoadExternalFeatures();
+	}
+}
+
+void UGameExperienceComponent::OnAsyncActionActivated(int32 ActionIndex, double ActionStartTime)
+{
+	if (LoadState != EGameExperienceLoadState::ExecutingActions)
+	{
+		// deactivated while activating
+		return;
+	}
+
+	const UGameFeatureAction* Action = QueuedActions.IsValidIndex(ActionIndex) ? QueuedActions[ActionIndex].Get() : nullptr;
+	LoadStats.AsyncActionDurations.Emplace(GetNameSafe(Action ? Action->GetClass() : nullptr), FPlatformTime::Seconds() - ActionStartTime);
+
+	--NumActionsActivating;
+
+	if (NumActionsActivating == 0 && NumExecutedActions == QueuedActions.Num())
+	{
+		LoadExternalFeatures();
 	}
 }
 
@@ -400,44 +1008,337 @@ void UGameExperienceComponent::RegisterExternalFeature(IGameExperienceExternalFe
 
 void UGameExperienceComponent::LoadExternalFeatures()
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(UGameExperienceComponent::LoadExternalFeatures, GameExperienceChannel);
+
 	check(LoadState != EGameExperienceLoadState::LoadingExternalFeatures);
 
-	NumExternalFeaturesLoading = ExternalFeatures.Num();
-	if (NumExternalFeaturesLoading > 0)
+	if (ExternalFeatures.IsEmpty())
+	{
+		OnExperienceLoaded();
+		return;
+	}
+
+	++ExternalFeatureLoadSerial;
+
+	// build the dependency graph
+	ExternalFeatureNodes.Reset(ExternalFeatures.Num());
+	TMap<FString, int32> FeatureIndicesByName;
+	for (IGameExperienceExternalFeatureInterface* ExternalFeature : ExternalFeatures)
 	{
-		SetLoadState(EGameExperienceLoadState::LoadingExternalFeatures);
+		FExternalFeatureNode& Node = ExternalFeatureNodes.AddDefaulted_GetRef();
+		Node.Feature = ExternalFeature;
+		Node.Name = ExternalFeature->GetFeatureName();
+		FeatureIndicesByName.Add(Node.Name, ExternalFeatureNodes.Num() - 1);
+	}
 
-		for (IGameExperienceExternalFeatureInterface* ExternalFeature : ExternalFeatures)
+	for (int32 Idx = 0; Idx < ExternalFeatureNodes.Num(); ++Idx)
+	{
+		FExternalFeatureNode& Node = ExternalFeatureNodes[Idx];
+		for (const FString& DependencyName : Node.Feature->GetFeatureDependencies())
 		{
-			ExternalFeature->LoadFeature(FSimpleDelegate::CreateUObject(this, &ThisClass::OnExternalFeatureLoaded));
+			const int32* DependencyIdx = FeatureIndicesByName.Find(DependencyName);
+			if (!DependencyIdx || *DependencyIdx == Idx)
+			{
+				UE_LOG(LogGameExperience, Warning, TEXT("%sExternal feature %s depends on %s, which is not registered"),
+					*GameExperiences::GetNetDebugPrefix(this), *Node.Name, *DependencyName);
+				continue;
+			}
+
+			ExternalFeatureNodes[*DependencyIdx].Dependents.AddUnique(Idx);
 		}
+	}
 
-		// clear after kicking off all loads
-		ExternalFeatures.Empty();
+	for (const FExternalFeatureNode& Node : ExternalFeatureNodes)
+	{
+		for (const int32 DependentIdx : Node.Dependents)
+		{
+			++ExternalFeatureNodes[DependentIdx].NumPendingDependencies;
+		}
 	}
-	else
+
+	// check for cycles by walking the graph in topological order
 	{
-		OnExperienceLoaded();
+		TArray<int32> PendingCounts;
+		TArray<int32> ReadyIndices;
+		for (int32 Idx = 0; Idx < ExternalFeatureNodes.Num(); ++Idx)
+		{
+			PendingCounts.Add(ExternalFeatureNodes[Idx].NumPendingDependencies);
+			if (PendingCounts[Idx] == 0)
+			{
+				ReadyIndices.Add(Idx);
+			}
+		}
+
+		int32 NumVisited = 0;
+		while (!ReadyIndices.IsEmpty())
+		{
+			const int32 Idx = ReadyIndices.Pop();
+			++NumVisited;
+			for (const int32 DependentIdx : ExternalFeatureNodes[Idx].Dependents)
+			{
+				if (--PendingCounts[DependentIdx] == 0)
+				{
+					ReadyIndices.Add(DependentIdx);
+				}
+			}
+		}
+
+		if (NumVisited < ExternalFeatureNodes.Num())
+		{
+			// the features left are either in a cycle or depend on one. find which features each of them can reach,
+			// since a dependency is part of a cycle only if its dependent can reach it again
+			TArray<TSet<int32>> ReachableIndices;
+			ReachableIndices.SetNum(ExternalFeatureNodes.Num());
+			for (int32 Idx = 0; Idx < ExternalFeatureNodes.Num(); ++Idx)
+			{
+				if (PendingCounts[Idx] == 0)
+				{
+					continue;
+				}
+
+				TArray<int32> Stack = ExternalFeatureNodes[Idx].Dependents;
+				while (!Stack.IsEmpty())
+				{
+					const int32 ReachedIdx = Stack.Pop();
+					bool bAlreadyReached = false;
+					ReachableIndices[Idx].Add(ReachedIdx, &bAlreadyReached);
+					if (!bAlreadyReached)
+					{
+						Stack.Append(ExternalFeatureNodes[ReachedIdx].Dependents);
+					}
+				}
+			}
+
+			// ignore only the dependencies that form a cycle, rather than never loading those features
+			for (int32 Idx = 0; Idx < ExternalFeatureNodes.Num(); ++Idx)
+			{
+				if (PendingCounts[Idx] == 0)
+				{
+					continue;
+				}
+
+				FExternalFeatureNode& Node = ExternalFeatureNodes[Idx];
+				for (int32 DependentNum = Node.Dependents.Num() - 1; DependentNum >= 0; --DependentNum)
+				{
+					const int32 DependentIdx = Node.Dependents[DependentNum];
+					if (!ReachableIndices[DependentIdx].Contains(Idx))
+					{
+						continue;
+					}
+
+					UE_LOG(LogGameExperience, Error, TEXT("%sExternal feature %s has a circular dependency on %s, it will be ignored"),
+						*GameExperiences::GetNetDebugPrefix(this), *ExternalFeatureNodes[DependentIdx].Name, *Node.Name);
+					Node.Dependents.RemoveAt(DependentNum);
+					--ExternalFeatureNodes[DependentIdx].NumPendingDependencies;
+				}
+			}
+		}
+	}
+
+	// clear once the graph is built, features register again for the next load
+	ExternalFeatures.Empty();
+
+	NumExternalFeaturesLoading = ExternalFeatureNodes.Num();
+	SetLoadState(EGameExperienceLoadState::LoadingExternalFeatures);
+
+	// start all features without dependencies, others start as their dependencies finish
+	const int32 LoadSerial = ExternalFeatureLoadSerial;
+	for (int32 Idx = 0; Idx < ExternalFeatureNodes.Num(); ++Idx)
+	{
+		if (LoadState != EGameExperienceLoadState::LoadingExternalFeatures || LoadSerial != ExternalFeatureLoadSerial)
+		{
+			// finished or deactivated by a feature that loaded immediately
+			break;
+		}
+
+		if (!ExternalFeatureNodes[Idx].bStarted && ExternalFeatureNodes[Idx].NumPendingDependencies == 0)
+		{
+			StartExternalFeature(Idx);
+		}
 	}
 }
 
-void UGameExperienceComponent::OnExternalFeatureLoaded()
+void UGameExperienceComponent::StartExternalFeature(int32 FeatureIndex)
 {
+	FExternalFeatureNode& Node = ExternalFeatureNodes[FeatureIndex];
+	check(!Node.bStarted);
+
+	Node.bStarted = true;
+	Node.StartTime = FPlatformTime::Seconds();
+
+	UE_LOG(LogGameExperience, Verbose, TEXT("%sLoading external feature: %s"),
+		*GameExperiences::GetNetDebugPrefix(this), *Node.Name);
+
+	const int32 LoadSerial = ExternalFeatureLoadSerial;
+
+	const float Timeout = Node.Feature->GetFeatureTimeout();
+	if (Timeout > 0.f)
+	{
+		GetWorldTimerManager().SetTimer(Node.TimeoutHandle, FTimerDelegate::CreateWeakLambda(this, [this, FeatureIndex, LoadSerial]()
+		{
+			if (LoadSerial == ExternalFeatureLoadSerial)
+			{
+				OnExternalFeatureTimedOut(FeatureIndex);
+			}
+		}), Timeout, /*InbLoop*/ false);
+	}
+
+	// the node may be invalidated after this call if the feature loads immediately
+	Node.Feature->LoadFeature(FSimpleDelegate::CreateWeakLambda(this, [this, FeatureIndex, LoadSerial]()
+	{
+		if (LoadSerial == ExternalFeatureLoadSerial)
+		{
+			OnExternalFeatureLoaded(FeatureIndex);
+		}
+	}));
+}
+
+void UGameExperienceComponent::OnExternalFeatureLoaded(int32 FeatureIndex)
+{
+	if (LoadState != EGameExperienceLoadState::LoadingExternalFeatures)
+	{
+		// deactivated while loading
+		return;
+	}
+
+	FExternalFeatureNode& Node = ExternalFeatureNodes[FeatureIndex];
+	if (Node.bFinished)
+	{
+		// finished after timing out
+		return;
+	}
+
+	Node.bFinished = true;
+	Node.EndTime = FPlatformTime::Seconds();
+	GetWorldTimerManager().ClearTimer(Node.TimeoutHandle);
+
+	LoadStats.ExternalFeatureDurations.Add(Node.Name, Node.EndTime - Node.StartTime);
+
 	--NumExternalFeaturesLoading;
 
 	// continue once all features are loaded
 	if (NumExternalFeaturesLoading == 0)
 	{
+		LogExternalFeatureCriticalPath();
 		OnExperienceLoaded();
+		return;
+	}
+
+	// start any dependents that were only waiting on this feature
+	const int32 LoadSerial = ExternalFeatureLoadSerial;
+	const TArray<int32> Dependents = Node.Dependents;
+	for (const int32 DependentIdx : Dependents)
+	{
+		if (LoadState != EGameExperienceLoadState::LoadingExternalFeatures || LoadSerial != ExternalFeatureLoadSerial)
+		{
+			break;
+		}
+
+		FExternalFeatureNode& Dependent = ExternalFeatureNodes[DependentIdx];
+		Dependent.CriticalDependency = FeatureIndex;
+		if (--Dependent.NumPendingDependencies == 0 && !Dependent.bStarted)
+		{
+			StartExternalFeature(DependentIdx);
+		}
+	}
+}
+
+void UGameExperienceComponent::OnExternalFeatureTimedOut(int32 FeatureIndex)
+{
+	if (LoadState != EGameExperienceLoadState::LoadingExternalFeatures || ExternalFeatureNodes[FeatureIndex].bFinished)
+	{
+		return;
+	}
+
+	const FExternalFeatureNode& Node = ExternalFeatureNodes[FeatureIndex];
+	const float Timeout = Node.Feature->GetFeatureTimeout();
+
+	switch (Node.Feature->GetFeatureTimeoutPolicy())
+	{
+	case EGameExperienceExternalFeatureTimeoutPolicy::Skip:
+		UE_LOG(LogGameExperience, Warning, TEXT("%sExternal feature %s did not load within %.1f s, skipping it"),
+			*GameExperiences::GetNetDebugPrefix(this), *Node.Name, Timeout);
+		OnExternalFeatureLoaded(FeatureIndex);
+		break;
+
+	case EGameExperienceExternalFeatureTimeoutPolicy::Fail:
+		FailExperienceLoad(FString::Printf(TEXT("External feature %s did not load within %.1f s"), *Node.Name, Timeout));
+		break;
 	}
 }
 
+void UGameExperienceComponent::FailExperienceLoad(const FString& Reason)
+{
+	UE_LOG(LogGameExperience, Error, TEXT("%s[%s] Game experience failed to load: %s"),
+		*GameExperiences::GetNetDebugPrefix(this),
+		*Experience->GetPrimaryAssetId().PrimaryAssetName.ToString(), *Reason);
+
+	// stop waiting on external features, and cancel any that are still loading
+	for (FExternalFeatureNode& Node : ExternalFeatureNodes)
+	{
+		GetWorldTimerManager().ClearTimer(Node.TimeoutHandle);
+	}
+	const TArray<FExternalFeatureNode> Nodes = MoveTemp(ExternalFeatureNodes);
+	ExternalFeatureNodes.Reset();
+	++ExternalFeatureLoadSerial;
+	NumExternalFeaturesLoading = 0;
+
+	for (const FExternalFeatureNode& Node : Nodes)
+	{
+		if (Node.bStarted && !Node.bFinished)
+		{
+			Node.Feature->CancelFeatureLoad();
+		}
+	}
+
+	LoadStats.TotalDuration = FPlatformTime::Seconds() - LoadStats.StartTime;
+	PendingSwitchExperience = nullptr;
+
+	SetLoadState(EGameExperienceLoadState::Failed);
+
+	OnExperienceLoadFailedEvent.Broadcast(Experience, Reason);
+}
+
+void UGameExperienceComponent::LogExternalFeatureCriticalPath()
+{
+	// the path ends at the feature that finished last
+	int32 LastIdx = INDEX_NONE;
+	for (int32 Idx = 0; Idx < ExternalFeatureNodes.Num(); ++Idx)
+	{
+		if (LastIdx == INDEX_NONE || ExternalFeatureNodes[Idx].EndTime > ExternalFeatureNodes[LastIdx].EndTime)
+		{
+			LastIdx = Idx;
+		}
+	}
+
+	TArray<FString>& CriticalPath = LoadStats.ExternalFeatureCriticalPath;
+	CriticalPath.Reset();
+	for (int32 Idx = LastIdx; Idx != INDEX_NONE; Idx = ExternalFeatureNodes[Idx].CriticalDependency)
+	{
+		CriticalPath.Insert(ExternalFeatureNodes[Idx].Name, 0);
+	}
+
+	UE_LOG(LogGameExperience, Verbose, TEXT("%sExternal feature critical path: %s"),
+		*GameExperiences::GetNetDebugPrefix(this), *FString::Join(CriticalPath, TEXT(" -> ")));
+}
+
 void UGameExperienceComponent::OnExperienceLoaded()
 {
 	check(LoadState != EGameExperienceLoadState::Loaded);
 
 	SetLoadState(EGameExperienceLoadState::Loaded);
 
+	LoadStats.TotalDuration = FPlatformTime::Seconds() - LoadStats.StartTime;
+
+#if CSV_PROFILER
+	CSV_CUSTOM_STAT(GameExperience, LoadTimeMs, static_cast<float>(LoadStats.TotalDuration * 1000.0), ECsvCustomStatOp::Set);
+	for (const TPair<EGameExperienceLoadState, double>& Elem : LoadStats.StateDurations)
+	{
+		const FString StatName = StaticEnum<EGameExperienceLoadState>()->GetNameStringByValue((uint8)Elem.Key) + TEXT("Ms");
+		FCsvProfiler::RecordCustomStat(*StatName, CSV_CATEGORY_INDEX(GameExperience), static_cast<float>(Elem.Value * 1000.0), ECsvCustomStatOp::Set);
+	}
+#endif
+
 	// broadcast events
 	OnExperienceLoadedEvent_HighPriority.Broadcast(Experience);
 	OnExperienceLoadedEvent_HighPriority.Clear();
@@ -448,62 +1349,93 @@ void UGameExperienceComponent::OnExperienceLoaded()
 	OnExperienceLoadedEvent_LowPriority.Broadcast(Experience);
 	OnExperienceLoadedEvent_LowPriority.Clear();
 
-	UE_LOG(LogGameExperience, Verbose, TEXT("%s[%s] Game experience ready."),
+	UE_LOG(LogGameExperience, Verbose, TEXT("%s[%s] Game experience ready in %.2f ms."),
 		*GameExperiences::GetNetDebugPrefix(this),
-		*Experience->GetPrimaryAssetId().PrimaryAssetName.ToString());
+		*Experience->GetPrimaryAssetId().PrimaryAssetName.ToString(),
+		LoadStats.TotalDuration * 1000.0);
+
+	// continue with any switch that was requested while loading
+	if (PendingSwitchExperience)
+	{
+		RequestSwitchExperience(PendingSwitchExperience);
+	}
 }
 
 void UGameExperienceComponent::DeactivateExperience()
 {
-	for (const FString& PluginURL : GameFeaturePluginURLs)
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(UGameExperienceComponent::DeactivateExperience, GameExperienceChannel);
+
+	if (LoadState == EGameExperienceLoadState::LoadingDefinition)
 	{
-		UGameFeaturesSubsystem::Get().DeactivateGameFeaturePlugin(PluginURL);
+		// nothing has been activated yet, just stop loading the definition
+		if (ExperienceDefLoadHandle.IsValid())
+		{
+			ExperienceDefLoadHandle->CancelHandle();
+			ExperienceDefLoadHandle.Reset();
+		}
+		SetLoadState(EGameExperienceLoadState::Unloaded);
+		return;
 	}
 
-	if (LoadState == EGameExperienceLoadState::Loaded)
+	if (LoadState == EGameExperienceLoadState::Unloaded ||
+		(LoadState == EGameExperienceLoadState::Deactivating && !bSwitchingExperience))
 	{
-		SetLoadState(EGameExperienceLoadState::Deactivating);
+		return;
+	}
 
-		NumExpectedPausers = INDEX_NONE;
-		NumPausers = 0;
+	// a switch in progress is abandoned, its pauser callbacks are ignored below
+	bSwitchingExperience = false;
+	PendingSwitchExperience = nullptr;
+	if (SwitchExperienceDefLoadHandle.IsValid())
+	{
+		SwitchExperienceDefLoadHandle->CancelHandle();
+		SwitchExperienceDefLoadHandle.Reset();
+	}
 
-		// setup a callback for deactivate complete
-		FGameFeatureDeactivatingContext Context(TEXT(""), [this](FStringView InPauserTag)
-			{
-				OnActionDeactivationCompleted();
-			});
+	SetLoadState(EGameExperienceLoadState::Deactivating);
 
-		if (const FWorldContext* WorldContext = GEngine->GetWorldContextFromWorld(GetWorld()))
-		{
-			Context.SetRequiredWorldContextHandle(WorldContext->ContextHandle);
-		}
+	// stop waiting on any external features
+	for (FExternalFeatureNode& Node : ExternalFeatureNodes)
+	{
+		GetWorldTimerManager().ClearTimer(Node.TimeoutHandle);
+	}
+	ExternalFeatureNodes.Reset();
+	++ExternalFeatureLoadSerial;
 
-		// deactivate all the actions
-		for (const UGameExperienceActionSet* ActionSet : Experience->ActionSets)
+	DeactivateUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+	DeactivatingExperienceName = Experience ? Experience->GetPrimaryAssetId().PrimaryAssetName.ToString() : FString();
+	NumExpectedPausers = INDEX_NONE;
+	NumPausers = 0;
+
+	// setup a callback for deactivate complete
+	FGameFeatureDeactivatingContext Context(TEXT(""), [this, Serial = ++ActionDeactivationSerial](FStringView InPauserTag)
 		{
-			if (!ActionSet)
+			if (Serial == ActionDeactivationSerial)
 			{
-				continue;
+				OnActionDeactivationCompleted();
 			}
+		});
 
-			for (UGameFeatureAction* Action : ActionSet->Actions)
-			{
-				if (!Action)
-				{
-					continue;
-				}
+	if (const FWorldContext* WorldContext = GEngine->GetWorldContextFromWorld(GetWorld()))
+	{
+		Context.SetRequiredWorldContextHandle(WorldContext->ContextHandle);
+	}
 
-				Action->OnGameFeatureDeactivating(Context);
-				Action->OnGameFeatureUnregistering();
-			}
+	// deactivate all the actions that were executed
+	for (int32 Idx = 0; Idx < NumExecutedActions; ++Idx)
+	{
+		if (UGameFeatureAction* Action = QueuedActions[Idx].Get())
+		{
+			Action->OnGameFeatureDeactivating(Context);
+			Action->OnGameFeatureUnregistering();
 		}
+	}
 
-		NumExpectedPausers = Context.GetNumPausers();
+	NumExpectedPausers = Context.GetNumPausers();
 
-		if (NumExpectedPausers == NumPausers)
-		{
-			OnAllActionsDeactivated();
-		}
+	if (NumExpectedPausers == NumPausers)
+	{
+		OnAllActionsDeactivated();
 	}
 }
 
@@ -513,13 +1445,21 @@ void UGameExperienceComponent::OnActionDeactivationCompleted()
 
 	if (NumPausers == NumExpectedPausers)
 	{
-		OnAllActionsDeactivated();
+		if (bSwitchingExperience)
+		{
+			OnSwitchActionsDeactivated();
+		}
+		else
+		{
+			OnAllActionsDeactivated();
+		}
 	}
 }
 
 void UGameExperienceComponent::OnAllActionsDeactivated()
 {
-	// TODO: actually unload, don't just deactivate
+	UnloadExperienceAssets();
+	UnloadGameFeaturePlugins();
 
 	SetLoadState(EGameExperienceLoadState::Unloaded);
 
@@ -529,6 +1469,98 @@ void UGameExperienceComponent::OnAllActionsDeactivated()
 	NumExpectedPausers = 0;
 	NumPausers = 0;
 	GameFeaturePluginURLs.Reset();
+	QueuedActions.Reset();
+	ActiveActionSets.Reset();
+	NumExecutedActions = 0;
+	NumActionsActivating = 0;
+	++ActionActivationSerial;
+	ExperienceManifest = FGameExperienceManifest();
+	bExperienceAssetsLoaded = false;
+	bGameFeaturePluginsRequested = false;
+
+	// continue with an experience that was requested while deactivating,
+	// e.g. replicated to a client, or replacing a failed experience
+	LoadPendingSwitchExperience();
+}
+
+void UGameExperienceComponent::LoadPendingSwitchExperience()
+{
+	if (!PendingSwitchExperience)
+	{
+		return;
+	}
+
+	Experience = PendingSwitchExperience;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ThisClass, Experience, this);
+	PendingSwitchExperience = nullptr;
+
+	LoadExperience();
+}
+
+void UGameExperienceComponent::UnloadExperienceAssets()
+{
+	if (BundleLoadHandle.IsValid())
+	{
+		// the loads may be shared with other experiences, so just drop the combined handle instead of canceling
+		BundleLoadHandle.Reset();
+	}
+
+	if (!BundleAssetIds.IsEmpty())
+	{
+		// unloads any assets that no other experience is using so they can be garbage collected
+		UGameExperienceEngineSubsystem::Get()->ReleaseAssetBundles(this, BundleAssetIds);
+		BundleAssetIds.Reset();
+	}
+}
+
+void UGameExperienceComponent::UnloadGameFeaturePlugins()
+{
+	ReleaseGameFeaturePlugins(GameFeaturePluginURLs);
+}
+
+void UGameExperienceComponent::ReleaseGameFeaturePlugins(const TArray<FString>& PluginURLs)
+{
+	UGameFeaturesSubsystem& GameFeaturesSubsystem = UGameFeaturesSubsystem::Get();
+
+	TSet<FString> ResidentPluginURLs;
+	for (const FString& PluginName : ResidentGameFeatures)
+	{
+		FString PluginURL;
+		if (GameFeaturesSubsystem.GetPluginURLByName(PluginName, PluginURL))
+		{
+			ResidentPluginURLs.Add(PluginURL);
+		}
+	}
+
+	// report memory once all plugins are done. this doesn't reference the component,
+	// since plugins may finish unloading after it has been destroyed, e.g. during EndPlay
+	const FString DebugPrefix = GameExperiences::GetNetDebugPrefix(this);
+	const FString ExperienceName = DeactivatingExperienceName;
+	const uint64 UsedPhysicalBefore = DeactivateUsedPhysical;
+
+	if (PluginURLs.IsEmpty())
+	{
+		GameExperiences::LogUnloadMemoryDelta(DebugPrefix, ExperienceName, UsedPhysicalBefore);
+		return;
+	}
+
+	const TSharedRef<int32> NumPluginsUnloading = MakeShared<int32>(PluginURLs.Num());
+	const FGameFeaturePluginChangeStateComplete OnPluginUnloaded = FGameFeaturePluginChangeStateComplete::CreateLambda(
+		[NumPluginsUnloading, DebugPrefix, ExperienceName, UsedPhysicalBefore](const UE::GameFeatures::FResult& Result)
+		{
+			if (--(*NumPluginsUnloading) == 0)
+			{
+				GameExperiences::LogUnloadMemoryDelta(DebugPrefix, ExperienceName, UsedPhysicalBefore);
+			}
+		});
+
+	// plugins are only deactivated once no other experience is using them
+	UGameExperienceEngineSubsystem* EngineSubsystem = UGameExperienceEngineSubsystem::Get();
+	for (const FString& PluginURL : PluginURLs)
+	{
+		const bool bUnload = bUnloadGameFeaturePlugins && !ResidentPluginURLs.Contains(PluginURL);
+		EngineSubsystem->ReleaseGameFeaturePlugin(PluginURL, bUnload, OnPluginUnloaded);
+	}
 }
 
 FPrimaryAssetId UGameExperienceComponent::ParseExperiencePrimaryAssetIdFromString(const FString& ExperienceIdString)
@@ -3,9 +3,16 @@
 
 #include "GameExperienceDef.h"
 
+#include "GameExperienceActionSet.h"
+#include "GameFeatureAction.h"
+#include "Engine/AssetManager.h"
 #include "Misc/PackageName.h"
 #include "UObject/Package.h"
 
+#if WITH_EDITOR
+#include "UObject/ObjectSaveContext.h"
+#endif
+
 
 UGameExperienceDef::UGameExperienceDef()
 {
@@ -29,3 +36,85 @@ FPrimaryAssetId UGameExperienceDef::GetPrimaryAssetId() const
 	// Data assets use Class and ShortName by default, there's no inheritance so class works fine
 	return FPrimaryAssetId(PrimaryAssetClass->GetFName(), GetFName());
 }
+
+#if WITH_EDITOR
+void UGameExperienceDef::PreSave(FObjectPreSaveContext ObjectSaveContext)
+{
+	Super::PreSave(ObjectSaveContext);
+
+	if (ObjectSaveContext.IsCooking())
+	{
+		BuildManifest(CookedManifest);
+	}
+	else
+	{
+		// don't save stale manifests into source assets
+		CookedManifest = FGameExperienceManifest();
+	}
+}
+#endif
+
+FGameExperienceManifest UGameExperienceDef::GetManifest() const
+{
+#if !WITH_EDITOR
+	if (CookedManifest.bIsValid)
+	{
+		return CookedManifest;
+	}
+#endif
+
+	FGameExperienceManifest Manifest;
+	BuildManifest(Manifest);
+	return Manifest;
+}
+
+void UGameExperienceDef::BuildManifest(FGameExperienceManifest& OutManifest) const
+{
+	OutManifest = FGameExperienceManifest();
+
+	OutManifest.BundleAssetIds.Add(GetPrimaryAssetId());
+
+	for (const UGameExperienceActionSet* ActionSet : ActionSets)
+	{
+		if (!ActionSet)
+		{
+			continue;
+		}
+
+		const FPrimaryAssetId ActionSetId = ActionSet->GetPrimaryAssetId();
+		if (ActionSetId.IsValid())
+		{
+			OutManifest.BundleAssetIds.AddUnique(ActionSetId);
+		}
+
+		for (const FString& PluginName : ActionSet->GameFeatures)
+		{
+			OutManifest.GameFeatures.AddUnique(PluginName);
+		}
+
+		for (const UGameFeatureAction* Action : ActionSet->Actions)
+		{
+			if (Action)
+			{
+				++OutManifest.NumActions;
+			}
+		}
+	}
+
+	// gather bundle names from the asset registry data
+	if (UAssetManager::IsInitialized())
+	{
+		const UAssetManager& AssetManager = UAssetManager::Get();
+		for (const FPrimaryAssetId& AssetId : OutManifest.BundleAssetIds)
+		{
+			TArray<FAssetBundleEntry> BundleEntries;
+			AssetManager.GetAssetBundleEntries(AssetId, BundleEntries);
+			for (const FAssetBundleEntry& BundleEntry : BundleEntries)
+			{
+				OutManifest.BundleNames.AddUnique(BundleEntry.BundleName);
+			}
+		}
+	}
+
+	OutManifest.bIsValid = true;
+}
@@ -0,0 +1,211 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+
+#include "GameExperienceEngineSubsystem.h"
+
+#include "GameExperiencesModule.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Engine.h"
+
+
+UGameExperienceEngineSubsystem* UGameExperienceEngineSubsystem::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UGameExperienceEngineSubsystem>() : nullptr;
+}
+
+void UGameExperienceEngineSubsystem::RequestGameFeaturePlugin(const FString& PluginURL, const FGameFeaturePluginLoadComplete& CompleteDelegate)
+{
+	const int32 RefCount = ++GameFeaturePluginRefCounts.FindOrAdd(PluginURL);
+
+	UE_LOG(LogGameExperience, Verbose, TEXT("Requested game feature plugin %s (%d refs)"), *PluginURL, RefCount);
+
+	// always go through the game features subsystem, it will complete immediately if the plugin
+	// is already active, or call the delegate along with any in-progress load if it is not
+	UGameFeaturesSubsystem::Get().LoadAndActivateGameFeaturePlugin(PluginURL, CompleteDelegate);
+}
+
+void UGameExperienceEngineSubsystem::ReleaseGameFeaturePlugin(const FString& PluginURL, bool bUnload,
+                                                              const FGameFeaturePluginChangeStateComplete& CompleteDelegate)
+{
+	int32* RefCount = GameFeaturePluginRefCounts.Find(PluginURL);
+	if (!ensureMsgf(RefCount, TEXT("[%hs] Game feature plugin was not requested: %s"), __func__, *PluginURL))
+	{
+		CompleteDelegate.ExecuteIfBound(UE::GameFeatures::FResult(MakeValue()));
+		return;
+	}
+
+	--(*RefCount);
+
+	UE_LOG(LogGameExperience, Verbose, TEXT("Released game feature plugin %s (%d refs)"), *PluginURL, *RefCount);
+
+	if (*RefCount > 0)
+	{
+		// still in use by another experience
+		CompleteDelegate.ExecuteIfBound(UE::GameFeatures::FResult(MakeValue()));
+		return;
+	}
+
+	GameFeaturePluginRefCounts.Remove(PluginURL);
+
+	if (bUnload && !IsGameFeaturePluginPinned(PluginURL))
+	{
+		UGameFeaturesSubsystem::Get().UnloadGameFeaturePlugin(PluginURL, CompleteDelegate);
+	}
+	else
+	{
+		UGameFeaturesSubsystem::Get().DeactivateGameFeaturePlugin(PluginURL, CompleteDelegate);
+	}
+}
+
+int32 UGameExperienceEngineSubsystem::GetGameFeaturePluginRefCount(const FString& PluginURL) const
+{
+	return GameFeaturePluginRefCounts.FindRef(PluginURL);
+}
+
+void UGameExperienceEngineSubsystem::PinGameFeaturePlugin(const FString& PluginURL)
+{
+	++GameFeaturePluginPinCounts.FindOrAdd(PluginURL);
+}
+
+void UGameExperienceEngineSubsystem::UnpinGameFeaturePlugin(const FString& PluginURL)
+{
+	int32* PinCount = GameFeaturePluginPinCounts.Find(PluginURL);
+	if (ensureMsgf(PinCount, TEXT("[%hs] Game feature plugin was not pinned: %s"), __func__, *PluginURL) && --(*PinCount) <= 0)
+	{
+		GameFeaturePluginPinCounts.Remove(PluginURL);
+	}
+}
+
+bool UGameExperienceEngineSubsystem::IsGameFeaturePluginPinned(const FString& PluginURL) const
+{
+	return GameFeaturePluginPinCounts.Contains(PluginURL);
+}
+
+bool UGameExperienceEngineSubsystem::FindGameFeaturePluginURL(const FString& PluginName, FString& OutPluginURL)
+{
+	if (const FString* CachedURL = GameFeaturePluginURLsByName.Find(PluginName))
+	{
+		OutPluginURL = *CachedURL;
+		return true;
+	}
+
+	// only cache successful lookups, plugins may still be discovered later
+	if (UGameFeaturesSubsystem::Get().GetPluginURLByName(PluginName, OutPluginURL))
+	{
+		GameFeaturePluginURLsByName.Add(PluginName, OutPluginURL);
+		return true;
+	}
+	return false;
+}
+
+TSharedPtr<FStreamableHandle> UGameExperienceEngineSubsystem::RequestAssetBundles(const UObject* Requester, const TArray<FPrimaryAssetId>& AssetIds,
+                                                                                 const TArray<FName>& BundleNames)
+{
+	if (AssetIds.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	// find assets that are missing some of the requested bundles
+	TArray<FPrimaryAssetId> AssetIdsToLoad;
+	for (const FPrimaryAssetId& AssetId : AssetIds)
+	{
+		FAssetBundleRef& BundleRef = AssetBundleRefs.FindOrAdd(AssetId);
+
+		// a second request would never be matched by a release, and keep the asset loaded forever
+		bool bAlreadyRequested = false;
+		BundleRef.Requesters.Add(FObjectKey(Requester), &bAlreadyRequested);
+		ensureMsgf(!bAlreadyRequested, TEXT("[%hs] Asset bundles were already requested by %s: %s"),
+			__func__, *GetNameSafe(Requester), *AssetId.ToString());
+
+		bool bHasAllBundles = true;
+		for (const FName& BundleName : BundleNames)
+		{
+			if (!BundleRef.BundleNames.Contains(BundleName))
+			{
+				BundleRef.BundleNames.Add(BundleName);
+				bHasAllBundles = false;
+			}
+		}
+
+		if (!bHasAllBundles)
+		{
+			AssetIdsToLoad.Add(AssetId);
+		}
+	}
+
+	UE_LOG(LogGameExperience, Verbose, TEXT("Requested bundles for %d assets (%d already loaded or loading)"),
+		AssetIds.Num(), AssetIds.Num() - AssetIdsToLoad.Num());
+
+	// load each asset separately, so that unloading one doesn't cancel loads that other experiences still need.
+	// bundles are only ever added while an asset is referenced, so the new state includes any previous ones
+	UAssetManager& AssetManager = UAssetManager::Get();
+	for (const FPrimaryAssetId& AssetId : AssetIdsToLoad)
+	{
+		FAssetBundleRef& BundleRef = AssetBundleRefs[AssetId];
+		BundleRef.LoadHandle = AssetManager.ChangeBundleStateForPrimaryAssets(
+			{AssetId}, BundleRef.BundleNames, {}, false, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+	}
+
+	// wait on every load that is still in progress, including ones started by other experiences
+	TArray<TSharedPtr<FStreamableHandle>> LoadingHandles;
+	for (const FPrimaryAssetId& AssetId : AssetIds)
+	{
+		const TSharedPtr<FStreamableHandle>& LoadHandle = AssetBundleRefs[AssetId].LoadHandle;
+		if (LoadHandle.IsValid() && LoadHandle->IsLoadingInProgress())
+		{
+			LoadingHandles.AddUnique(LoadHandle);
+		}
+	}
+
+	if (LoadingHandles.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	// always combine, so that each caller gets its own handle to bind delegates to
+	return AssetManager.GetStreamableManager().CreateCombinedHandle(LoadingHandles);
+}
+
+void UGameExperienceEngineSubsystem::ReleaseAssetBundles(const UObject* Requester, const TArray<FPrimaryAssetId>& AssetIds)
+{
+	if (AssetIds.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<FPrimaryAssetId> AssetIdsToUnload;
+	for (const FPrimaryAssetId& AssetId : AssetIds)
+	{
+		FAssetBundleRef* BundleRef = AssetBundleRefs.Find(AssetId);
+		if (!ensureMsgf(BundleRef && BundleRef->Requesters.Remove(FObjectKey(Requester)) > 0,
+			TEXT("[%hs] Asset bundles were not requested by %s: %s"), __func__, *GetNameSafe(Requester), *AssetId.ToString()))
+		{
+			continue;
+		}
+
+		if (!BundleRef->Requesters.IsEmpty())
+		{
+			// still in use by another experience
+			continue;
+		}
+
+		AssetBundleRefs.Remove(AssetId);
+		AssetIdsToUnload.Add(AssetId);
+	}
+
+	UE_LOG(LogGameExperience, Verbose, TEXT("Released bundles for %d assets (%d unloaded)"),
+		AssetIds.Num(), AssetIdsToUnload.Num());
+
+	if (!AssetIdsToUnload.IsEmpty())
+	{
+		// release the bundle state so the assets can be garbage collected, this also cancels any in-progress load
+		UAssetManager::Get().UnloadPrimaryAssets(AssetIdsToUnload);
+	}
+}
+
+int32 UGameExperienceEngineSubsystem::GetAssetBundleRefCount(const FPrimaryAssetId& AssetId) const
+{
+	const FAssetBundleRef* BundleRef = AssetBundleRefs.Find(AssetId);
+	return BundleRef ? BundleRef->Requesters.Num() : 0;
+}
@@ -4,4 +4,21 @@
 #include "GameExperienceExternalFeatureInterface.h"
 
 
-// Add default functionality here for any IGameExperienceExternalFeatureInterface functions that are not pure virtual.
+void IGameExperienceExternalFeatureInterface::CancelFeatureLoad()
+{
+}
+
+TArray<FString> IGameExperienceExternalFeatureInterface::GetFeatureDependencies() const
+{
+	return TArray<FString>();
+}
+
+float IGameExperienceExternalFeatureInterface::GetFeatureTimeout() const
+{
+	return 0.f;
+}
+
+EGameExperienceExternalFeatureTimeoutPolicy IGameExperienceExternalFeatureInterface::GetFeatureTimeoutPolicy() const
+{
+	return EGameExperienceExternalFeatureTimeoutPolicy::Skip;
+}
@@ -0,0 +1,66 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+
+#include "GameExperienceManifestCommandlet.h"
+
+#include "GameExperienceDef.h"
+#include "GameExperiencesModule.h"
+#include "JsonObjectConverter.h"
+#include "Dom/JsonObject.h"
+#include "Engine/AssetManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+
+
+UGameExperienceManifestCommandlet::UGameExperienceManifestCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UGameExperienceManifestCommandlet::Main(const FString& Params)
+{
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("GameExperiences") / TEXT("ExperienceManifests.json");
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	UAssetManager& AssetManager = UAssetManager::Get();
+
+	TArray<FPrimaryAssetId> ExperienceIds;
+	AssetManager.GetPrimaryAssetIdList(FPrimaryAssetType(UGameExperienceDef::StaticClass()->GetFName()), ExperienceIds);
+	ExperienceIds.Sort([](const FPrimaryAssetId& A, const FPrimaryAssetId& B) { return A.ToString() < B.ToString(); });
+
+	const TSharedRef<FJsonObject> RootObject = MakeShared<FJsonObject>();
+
+	for (const FPrimaryAssetId& ExperienceId : ExperienceIds)
+	{
+		const UClass* ExperienceClass = Cast<UClass>(AssetManager.GetPrimaryAssetPath(ExperienceId).TryLoad());
+		if (!ExperienceClass)
+		{
+			UE_LOG(LogGameExperience, Warning, TEXT("Failed to load GameExperience '%s'"), *ExperienceId.ToString());
+			continue;
+		}
+
+		FGameExperienceManifest Manifest;
+		ExperienceClass->GetDefaultObject<UGameExperienceDef>()->BuildManifest(Manifest);
+
+		UE_LOG(LogGameExperience, Display, TEXT("%s: %d game features, %d bundle assets, %d bundles, %d actions"),
+			*ExperienceId.ToString(), Manifest.GameFeatures.Num(), Manifest.BundleAssetIds.Num(),
+			Manifest.BundleNames.Num(), Manifest.NumActions);
+
+		RootObject->SetObjectField(ExperienceId.ToString(), FJsonObjectConverter::UStructToJsonObject(Manifest));
+	}
+
+	FString OutputString;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutputString);
+	if (!FJsonSerializer::Serialize(RootObject, Writer) || !FFileHelper::SaveStringToFile(OutputString, *OutputPath))
+	{
+		UE_LOG(LogGameExperience, Error, TEXT("Failed to write experience manifests to %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogGameExperience, Display, TEXT("Wrote %d experience manifests to %s"), ExperienceIds.Num(), *OutputPath);
+	return 0;
+}
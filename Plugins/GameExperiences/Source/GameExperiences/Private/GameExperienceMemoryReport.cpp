@@ -0,0 +1,248 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+
+#include "GameExperienceMemoryReport.h"
+
+#include "GameExperienceComponent.h"
+#include "GameExperienceDef.h"
+#include "GameExperiencesModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/AssetManager.h"
+#include "Engine/World.h"
+#include "Interfaces/IPluginManager.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectHash.h"
+
+
+namespace GameExperiences
+{
+	/** Add a package and all of its hard package dependencies to a set. */
+	void GatherPackageDependencies(const IAssetRegistry& AssetRegistry, FName PackageName, TSet<FName>& OutPackageNames)
+	{
+		TArray<FName> PackagesToVisit = {PackageName};
+		while (!PackagesToVisit.IsEmpty())
+		{
+			const FName VisitName = PackagesToVisit.Pop();
+
+			bool bAlreadyInSet = false;
+			OutPackageNames.Add(VisitName, &bAlreadyInSet);
+			if (bAlreadyInSet)
+			{
+				continue;
+			}
+
+			TArray<FName> Dependencies;
+			AssetRegistry.GetDependencies(VisitName, Dependencies,
+				UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+
+			for (const FName& Dependency : Dependencies)
+			{
+				// native packages aren't attributable to the experience
+				if (!Dependency.ToString().StartsWith(TEXT("/Script/")))
+				{
+					PackagesToVisit.Add(Dependency);
+				}
+			}
+		}
+	}
+
+	/** Fill in a report entry from a set of packages, skipping and then claiming packages already counted by previous entries. */
+	FGameExperienceMemoryReport::FEntry MakeMemoryReportEntry(const FString& Name, const TSet<FName>& PackageNames, TSet<FName>& ClaimedPackageNames)
+	{
+		FGameExperienceMemoryReport::FEntry Entry;
+		Entry.Name = Name;
+
+		for (const FName& PackageName : PackageNames)
+		{
+			bool bAlreadyClaimed = false;
+			ClaimedPackageNames.Add(PackageName, &bAlreadyClaimed);
+			if (bAlreadyClaimed)
+			{
+				continue;
+			}
+
+			++Entry.NumPackages;
+
+			bool bIsLoaded = false;
+			Entry.ResidentBytes += FGameExperienceMemoryReport::GetPackageResidentBytes(PackageName, bIsLoaded);
+			if (bIsLoaded)
+			{
+				++Entry.NumLoadedPackages;
+			}
+		}
+		return Entry;
+	}
+
+	void DumpMemoryReport(UWorld* World)
+	{
+		const UGameExperienceComponent* ExperienceComponent = UGameExperienceComponent::Get(World);
+		const UGameExperienceDef* Experience = ExperienceComponent ? ExperienceComponent->GetExperience() : nullptr;
+		if (!Experience)
+		{
+			UE_LOG(LogGameExperience, Log, TEXT("No game experience in the current world"));
+			return;
+		}
+
+		FGameExperienceMemoryReport Report;
+		Report.Build(Experience);
+		Report.Log(Experience->GetPrimaryAssetId().PrimaryAssetName.ToString());
+	}
+}
+
+FAutoConsoleCommandWithWorld CmdGameExperienceMemoryReport(
+	TEXT("experience.MemoryReport"),
+	TEXT("Log the resident memory of the experience in the current world, per action set, bundle and game feature plugin."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&GameExperiences::DumpMemoryReport));
+
+
+void FGameExperienceMemoryReport::Build(const UGameExperienceDef* Experience, const TArray<FName>& BundleNamesFilter)
+{
+	ActionSets.Reset();
+	Bundles.Reset();
+	Plugins.Reset();
+	TotalResidentBytes = 0;
+
+	if (!Experience)
+	{
+		return;
+	}
+
+	FGameExperienceManifest Manifest = Experience->GetManifest();
+	if (!BundleNamesFilter.IsEmpty())
+	{
+		Manifest.BundleNames.RemoveAll([&BundleNamesFilter](const FName& BundleName) { return !BundleNamesFilter.Contains(BundleName); });
+	}
+
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	const UAssetManager& AssetManager = UAssetManager::Get();
+
+	// gather packages per action set and per bundle
+	TSet<FName> AllPackageNames;
+	TMap<FName, TSet<FName>> PackageNamesByBundle;
+	TSet<FName> ClaimedByActionSets;
+
+	for (const FPrimaryAssetId& AssetId : Manifest.BundleAssetIds)
+	{
+		TSet<FName> ActionSetPackageNames;
+		for (const FName& BundleName : Manifest.BundleNames)
+		{
+			TSet<FSoftObjectPath> AssetPaths;
+			AssetManager.GetPrimaryAssetLoadSet(AssetPaths, AssetId, {BundleName}, false);
+
+			TSet<FName>& BundlePackageNames = PackageNamesByBundle.FindOrAdd(BundleName);
+			for (const FSoftObjectPath& AssetPath : AssetPaths)
+			{
+				const FName PackageName = AssetPath.GetLongPackageFName();
+				GatherPackageDependencies(AssetRegistry, PackageName, BundlePackageNames);
+				GatherPackageDependencies(AssetRegistry, PackageName, ActionSetPackageNames);
+			}
+		}
+
+		// the primary asset itself, in case it has no bundles
+		const FSoftObjectPath PrimaryAssetPath = AssetManager.GetPrimaryAssetPath(AssetId);
+		if (!PrimaryAssetPath.IsNull())
+		{
+			GatherPackageDependencies(AssetRegistry, PrimaryAssetPath.GetLongPackageFName(), ActionSetPackageNames);
+		}
+
+		ActionSets.Add(GameExperiences::MakeMemoryReportEntry(AssetId.ToString(), ActionSetPackageNames, ClaimedByActionSets));
+		AllPackageNames.Append(ActionSetPackageNames);
+	}
+
+	// bundles can overlap, e.g. assets used by both client and server
+	for (const TPair<FName, TSet<FName>>& Elem : PackageNamesByBundle)
+	{
+		TSet<FName> ClaimedByBundle;
+		Bundles.Add(GameExperiences::MakeMemoryReportEntry(Elem.Key.ToString(), Elem.Value, ClaimedByBundle));
+	}
+
+	// plugin content is attributed by mount point, dependencies outside the plugin are counted by action sets
+	for (const FString& PluginName : Manifest.GameFeatures)
+	{
+		const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(PluginName);
+		if (!Plugin.IsValid() || !Plugin->CanContainContent())
+		{
+			continue;
+		}
+
+		TArray<FAssetData> PluginAssets;
+		FString MountedAssetPath = Plugin->GetMountedAssetPath();
+		MountedAssetPath.RemoveFromEnd(TEXT("/"));
+		AssetRegistry.GetAssetsByPath(FName(MountedAssetPath), PluginAssets, true);
+
+		TSet<FName> PluginPackageNames;
+		for (const FAssetData& AssetData : PluginAssets)
+		{
+			PluginPackageNames.Add(AssetData.PackageName);
+		}
+
+		TSet<FName> ClaimedByPlugin;
+		Plugins.Add(GameExperiences::MakeMemoryReportEntry(PluginName, PluginPackageNames, ClaimedByPlugin));
+		AllPackageNames.Append(PluginPackageNames);
+	}
+
+	for (const FName& PackageName : AllPackageNames)
+	{
+		bool bIsLoaded = false;
+		TotalResidentBytes += GetPackageResidentBytes(PackageName, bIsLoaded);
+	}
+}
+
+void FGameExperienceMemoryReport::Log(const FString& ExperienceName) const
+{
+	const auto LogEntries = [](const TCHAR* Category, const TArray<FEntry>& Entries)
+	{
+		for (const FEntry& Entry : Entries)
+		{
+			UE_LOG(LogGameExperience, Log, TEXT("  %s %s: %.2f MB (%d / %d packages loaded)"),
+				Category, *Entry.Name, Entry.ResidentBytes / (1024.0 * 1024.0), Entry.NumLoadedPackages, Entry.NumPackages);
+		}
+	};
+
+	UE_LOG(LogGameExperience, Log, TEXT("[%s] Memory report, total resident: %.2f MB"),
+		*ExperienceName, TotalResidentBytes / (1024.0 * 1024.0));
+	LogEntries(TEXT("ActionSet"), ActionSets);
+	LogEntries(TEXT("Bundle"), Bundles);
+	LogEntries(TEXT("Plugin"), Plugins);
+}
+
+FString FGameExperienceMemoryReport::ToCsv(const FString& ExperienceName) const
+{
+	FString Csv;
+	const auto AddRows = [&Csv, &ExperienceName](const TCHAR* Category, const TArray<FEntry>& Entries)
+	{
+		for (const FEntry& Entry : Entries)
+		{
+			Csv += FString::Printf(TEXT("%s,%s,%s,%d,%d,%lld\n"),
+				*ExperienceName, Category, *Entry.Name, Entry.NumPackages, Entry.NumLoadedPackages, Entry.ResidentBytes);
+		}
+	};
+
+	AddRows(TEXT("ActionSet"), ActionSets);
+	AddRows(TEXT("Bundle"), Bundles);
+	AddRows(TEXT("Plugin"), Plugins);
+	Csv += FString::Printf(TEXT("%s,Total,,,,%lld\n"), *ExperienceName, TotalResidentBytes);
+	return Csv;
+}
+
+int64 FGameExperienceMemoryReport::GetPackageResidentBytes(FName PackageName, bool& bOutIsLoaded)
+{
+	const UPackage* Package = FindPackage(nullptr, *PackageName.ToString());
+	bOutIsLoaded = Package != nullptr;
+	if (!Package)
+	{
+		return 0;
+	}
+
+	// same accounting as 'obj list', the object's own memory plus any exclusive resources
+	int64 Bytes = 0;
+	ForEachObjectWithPackage(Package, [&Bytes](UObject* Object)
+	{
+		FArchiveCountMem CountMem(Object);
+		Bytes += CountMem.GetMax();
+		Bytes += Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		return true;
+	});
+	return Bytes;
+}
@@ -0,0 +1,101 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+
+#include "GameExperienceMemoryReportCommandlet.h"
+
+#include "GameExperienceDef.h"
+#include "GameExperienceMemoryReport.h"
+#include "GameExperiencesModule.h"
+#include "Engine/AssetManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+
+
+UGameExperienceMemoryReportCommandlet::UGameExperienceMemoryReportCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UGameExperienceMemoryReportCommandlet::Main(const FString& Params)
+{
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("GameExperiences") / TEXT("MemoryReport.csv");
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	// report on a single bundle to budget e.g. dedicated servers, defaults to every bundle of the experience
+	TArray<FName> BundleNamesFilter;
+	FString BundlesParam;
+	if (FParse::Value(*Params, TEXT("Bundles="), BundlesParam, false))
+	{
+		TArray<FString> BundleNameStrings;
+		BundlesParam.ParseIntoArray(BundleNameStrings, TEXT(","));
+		for (const FString& BundleNameString : BundleNameStrings)
+		{
+			BundleNamesFilter.Add(FName(BundleNameString.TrimStartAndEnd()));
+		}
+	}
+
+	UAssetManager& AssetManager = UAssetManager::Get();
+
+	TArray<FPrimaryAssetId> ExperienceIds;
+	FString ExperienceParam;
+	if (FParse::Value(*Params, TEXT("Experience="), ExperienceParam))
+	{
+		ExperienceIds.Add(FPrimaryAssetId(ExperienceParam));
+	}
+	else
+	{
+		AssetManager.GetPrimaryAssetIdList(FPrimaryAssetType(UGameExperienceDef::StaticClass()->GetFName()), ExperienceIds);
+		ExperienceIds.Sort([](const FPrimaryAssetId& A, const FPrimaryAssetId& B) { return A.ToString() < B.ToString(); });
+	}
+
+	FString Csv = TEXT("Experience,Category,Name,Packages,LoadedPackages,ResidentBytes\n");
+
+	for (const FPrimaryAssetId& ExperienceId : ExperienceIds)
+	{
+		const UClass* ExperienceClass = Cast<UClass>(AssetManager.GetPrimaryAssetPath(ExperienceId).TryLoad());
+		if (!ExperienceClass)
+		{
+			UE_LOG(LogGameExperience, Warning, TEXT("Failed to load GameExperience '%s'"), *ExperienceId.ToString());
+			continue;
+		}
+
+		const UGameExperienceDef* Experience = ExperienceClass->GetDefaultObject<UGameExperienceDef>();
+		const FGameExperienceManifest Manifest = Experience->GetManifest();
+
+		TArray<FName> BundlesToLoad = Manifest.BundleNames;
+		if (!BundleNamesFilter.IsEmpty())
+		{
+			BundlesToLoad.RemoveAll([&BundleNamesFilter](const FName& BundleName) { return !BundleNamesFilter.Contains(BundleName); });
+		}
+
+		// load only this experience's bundles so that the report isn't skewed by the previous one
+		const TSharedPtr<FStreamableHandle> LoadHandle = AssetManager.LoadPrimaryAssets(Manifest.BundleAssetIds, BundlesToLoad);
+		if (LoadHandle.IsValid())
+		{
+			LoadHandle->WaitUntilComplete();
+		}
+
+		FGameExperienceMemoryReport Report;
+		Report.Build(Experience, BundleNamesFilter);
+
+		const FString ExperienceName = ExperienceId.PrimaryAssetName.ToString();
+		Report.Log(ExperienceName);
+		Csv += Report.ToCsv(ExperienceName);
+
+		AssetManager.UnloadPrimaryAssets(Manifest.BundleAssetIds);
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *OutputPath))
+	{
+		UE_LOG(LogGameExperience, Error, TEXT("Failed to write experience memory report to %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogGameExperience, Display, TEXT("Wrote memory report for %d experiences to %s"), ExperienceIds.Num(), *OutputPath);
+	return 0;
+}
@@ -0,0 +1,140 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+
+#include "GameExperiencePlayerComponent.h"
+
+#include "ExperienceGameModeBase.h"
+#include "GameExperiencesModule.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+
+
+namespace GameExperiences
+{
+	void DumpClientLoadStats(UWorld* World)
+	{
+		for (TActorIterator<APlayerController> It(World); It; ++It)
+		{
+			const UGameExperiencePlayerComponent* PlayerComponent = UGameExperiencePlayerComponent::FindForController(*It);
+			if (!PlayerComponent)
+			{
+				continue;
+			}
+
+			UE_LOG(LogGameExperience, Log, TEXT("%s: %s, loaded in %.2f s"),
+				It->PlayerState ? *It->PlayerState->GetPlayerName() : *It->GetName(),
+				*StaticEnum<EGameExperienceLoadState>()->GetNameStringByValue((uint8)PlayerComponent->GetClientLoadState()),
+				PlayerComponent->GetClientLoadDuration());
+		}
+	}
+}
+
+
+FAutoConsoleCommandWithWorld CmdGameExperienceDumpClientLoadStats(
+	TEXT("experience.DumpClientLoadStats"),
+	TEXT("Log the experience load state and load time reported by each client. Server only."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&GameExperiences::DumpClientLoadStats));
+
+
+UGameExperiencePlayerComponent::UGameExperiencePlayerComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	SetIsReplicatedByDefault(true);
+}
+
+void UGameExperiencePlayerComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (HasAuthority())
+	{
+		ServerStartTime = FPlatformTime::Seconds();
+	}
+
+	const APlayerController* PC = GetController<APlayerController>();
+	if (!PC || !PC->IsLocalController())
+	{
+		return;
+	}
+
+	UGameExperienceComponent::OnExperienceLoadStateChangedEvent.AddUObject(this, &ThisClass::OnExperienceLoadStateChanged);
+
+	// report the current state, in case the experience started loading before this component
+	if (const UGameExperienceComponent* ExperienceComponent = UGameExperienceComponent::Get(this))
+	{
+		ReportLoadState(ExperienceComponent->GetLoadState());
+	}
+}
+
+void UGameExperiencePlayerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UGameExperienceComponent::OnExperienceLoadStateChangedEvent.RemoveAll(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+double UGameExperiencePlayerComponent::GetClientLoadDuration() const
+{
+	return IsClientExperienceLoaded() ? ClientLoadedTime - ServerStartTime : -1.0;
+}
+
+UGameExperiencePlayerComponent* UGameExperiencePlayerComponent::FindForController(const AController* Controller)
+{
+	return Controller ? Controller->FindComponentByClass<UGameExperiencePlayerComponent>() : nullptr;
+}
+
+void UGameExperiencePlayerComponent::OnExperienceLoadStateChanged(UGameExperienceComponent* ExperienceComp, EGameExperienceLoadState NewLoadState)
+{
+	if (ExperienceComp->GetWorld() == GetWorld())
+	{
+		ReportLoadState(NewLoadState);
+	}
+}
+
+void UGameExperiencePlayerComponent::ReportLoadState(EGameExperienceLoadState NewLoadState)
+{
+	if (NewLoadState == LastReportedLoadState)
+	{
+		return;
+	}
+
+	LastReportedLoadState = NewLoadState;
+
+	if (HasAuthority())
+	{
+		// listen server or standalone, no need to send anything
+		SetClientLoadState(NewLoadState);
+	}
+	else
+	{
+		ServerReportLoadState(NewLoadState);
+	}
+}
+
+void UGameExperiencePlayerComponent::SetClientLoadState(EGameExperienceLoadState NewLoadState)
+{
+	ClientLoadState = NewLoadState;
+
+	if (NewLoadState != EGameExperienceLoadState::Loaded)
+	{
+		return;
+	}
+
+	ClientLoadedTime = FPlatformTime::Seconds();
+
+	APlayerController* PC = GetController<APlayerController>();
+
+	UE_LOG(LogGameExperience, Log, TEXT("%s finished loading the experience in %.2f s"),
+		PC && PC->PlayerState ? *PC->PlayerState->GetPlayerName() : *GetNameSafe(PC), GetClientLoadDuration());
+
+	if (AExperienceGameModeBase* GameMode = GetWorld()->GetAuthGameMode<AExperienceGameModeBase>())
+	{
+		GameMode->OnPlayerExperienceLoaded(PC);
+	}
+}
+
+void UGameExperiencePlayerComponent::ServerReportLoadState_Implementation(EGameExperienceLoadState NewLoadState)
+{
+	SetClientLoadState(NewLoadState);
+}
@@ -0,0 +1,317 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+
+#include "GameExperiencePrewarmSubsystem.h"
+
+#include "GameExperienceComponent.h"
+#include "GameExperienceDef.h"
+#include "GameExperienceEngineSubsystem.h"
+#include "GameExperienceEntryPoint.h"
+#include "GameExperiencesModule.h"
+#include "GameFeaturesSubsystem.h"
+#include "GameFeaturesSubsystemSettings.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/NetDriver.h"
+#include "Engine/PendingNetGame.h"
+#include "Engine/World.h"
+
+
+TAutoConsoleVariable CVarGameExperiencePrewarmTravelURL(
+	TEXT("experience.PrewarmTravelURL"),
+	true,
+	TEXT("When traveling to a server, prewarm the experience from the travel URL options while the map loads."));
+
+
+void UGameExperiencePrewarmSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	ExperienceLoadingHandle = UGameExperienceComponent::OnExperienceLoadingEvent.AddUObject(this, &ThisClass::OnExperienceLoading);
+	PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMapWithContext.AddUObject(this, &ThisClass::OnPreLoadMap);
+	TravelFailureHandle = GEngine->OnTravelFailure().AddUObject(this, &ThisClass::OnTravelFailure);
+	NetworkFailureHandle = GEngine->OnNetworkFailure().AddUObject(this, &ThisClass::OnNetworkFailure);
+}
+
+void UGameExperiencePrewarmSubsystem::Deinitialize()
+{
+	UGameExperienceComponent::OnExperienceLoadingEvent.Remove(ExperienceLoadingHandle);
+	FCoreUObjectDelegates::PreLoadMapWithContext.Remove(PreLoadMapHandle);
+	if (GEngine)
+	{
+		GEngine->OnTravelFailure().Remove(TravelFailureHandle);
+		GEngine->OnNetworkFailure().Remove(NetworkFailureHandle);
+	}
+
+	ReleaseAllPrewarmedExperiences();
+
+	Super::Deinitialize();
+}
+
+void UGameExperiencePrewarmSubsystem::PrewarmExperience(FPrimaryAssetId ExperienceId)
+{
+	if (!ExperienceId.IsValid() || PrewarmedExperiences.Contains(ExperienceId))
+	{
+		return;
+	}
+
+	UAssetManager& AssetManager = UAssetManager::Get();
+	const FSoftObjectPath AssetPath = AssetManager.GetPrimaryAssetPath(ExperienceId);
+	if (AssetPath.IsNull())
+	{
+		UE_LOG(LogGameExperience, Error, TEXT("Could not find GameExperience '%s' to prewarm"), *ExperienceId.ToString());
+		return;
+	}
+
+	UE_LOG(LogGameExperience, Log, TEXT("Prewarming GameExperience '%s'"), *ExperienceId.ToString());
+
+	PrewarmedExperiences.Add(ExperienceId);
+	const TSharedPtr<FStreamableHandle> DefinitionHandle = AssetManager.GetStreamableManager().RequestAsyncLoad(
+		AssetPath, FStreamableDelegate::CreateUObject(this, &ThisClass::OnDefinitionLoaded, ExperienceId));
+
+	// the delegate may have been called already, and the map may have changed
+	if (FPrewarmedExperience* PrewarmPtr = PrewarmedExperiences.Find(ExperienceId))
+	{
+		PrewarmPtr->DefinitionHandle = DefinitionHandle;
+	}
+}
+
+void UGameExperiencePrewarmSubsystem::PrewarmExperienceByName(const FString& ExperienceName)
+{
+	if (ExperienceName.IsEmpty())
+	{
+		return;
+	}
+
+	// treated like a travel experience, so it's released if joining fails
+	TravelExperienceId = UGameExperienceComponent::ParseExperiencePrimaryAssetIdFromString(ExperienceName);
+	PrewarmExperience(TravelExperienceId);
+}
+
+void UGameExperiencePrewarmSubsystem::PrewarmEntryPoint(const UGameExperienceEntryPoint* EntryPoint)
+{
+	if (EntryPoint && EntryPoint->GameExperience.IsValid())
+	{
+		PrewarmExperience(EntryPoint->GameExperience);
+	}
+}
+
+void UGameExperiencePrewarmSubsystem::OnDefinitionLoaded(FPrimaryAssetId ExperienceId)
+{
+	FPrewarmedExperience* Prewarm = PrewarmedExperiences.Find(ExperienceId);
+	if (!Prewarm || Prewarm->bDefinitionLoaded)
+	{
+		// released while loading
+		return;
+	}
+
+	UAssetManager& AssetManager = UAssetManager::Get();
+	const TSubclassOf<UGameExperienceDef> ExperienceClass = Cast<UClass>(AssetManager.GetPrimaryAssetPath(ExperienceId).ResolveObject());
+	if (!ExperienceClass)
+	{
+		UE_LOG(LogGameExperience, Error, TEXT("Failed to load GameExperience '%s' to prewarm"), *ExperienceId.ToString());
+		ReleasePrewarmedExperience(ExperienceId);
+		return;
+	}
+
+	Prewarm->bDefinitionLoaded = true;
+
+	const FGameExperienceManifest Manifest = ExperienceClass->GetDefaultObject<UGameExperienceDef>()->GetManifest();
+
+	// the net mode of the destination isn't known yet, so load everything this process could need
+	TArray<FName> BundlesToLoad;
+	if (!IsRunningDedicatedServer())
+	{
+		BundlesToLoad.Add(UGameFeaturesSubsystemSettings::LoadStateClient);
+	}
+	if (!IsRunningClientOnly())
+	{
+		BundlesToLoad.Add(UGameFeaturesSubsystemSettings::LoadStateServer);
+	}
+
+	// preloaded assets are not tracked in the asset manager bundle state, so they
+	// won't interfere with experience components loading and unloading the same bundles
+	Prewarm->BundleHandle = AssetManager.PreloadPrimaryAssets(
+		Manifest.BundleAssetIds, BundlesToLoad, false, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+
+	// load plugins without activating them, activation is left to the experience component.
+	// pin them so that deactivating the previous experience during travel doesn't unload them again
+	UGameExperienceEngineSubsystem* EngineSubsystem = UGameExperienceEngineSubsystem::Get();
+	for (const FString& PluginName : Manifest.GameFeatures)
+	{
+		FString PluginURL;
+		if (EngineSubsystem->FindGameFeaturePluginURL(PluginName, PluginURL))
+		{
+			Prewarm->GameFeaturePluginURLs.Add(PluginURL);
+			EngineSubsystem->PinGameFeaturePlugin(PluginURL);
+		}
+	}
+
+	Prewarm->NumPluginsLoading = Prewarm->GameFeaturePluginURLs.Num();
+
+	// only plugins loaded by the prewarm are unloaded on release, others were loaded by the project or another experience
+	UGameFeaturesSubsystem& GameFeaturesSubsystem = UGameFeaturesSubsystem::Get();
+	for (const FString& PluginURL : Prewarm->GameFeaturePluginURLs)
+	{
+		if (!GameFeaturesSubsystem.IsGameFeaturePluginLoaded(PluginURL))
+		{
+			Prewarm->LoadedPluginURLs.Add(PluginURL);
+		}
+	}
+
+	// copy since the delegate can be called immediately
+	const TArray<FString> PluginURLs = Prewarm->GameFeaturePluginURLs;
+	for (const FString& PluginURL : PluginURLs)
+	{
+		GameFeaturesSubsystem.LoadGameFeaturePlugin(
+			PluginURL, FGameFeaturePluginLoadComplete::CreateUObject(this, &ThisClass::OnGameFeaturePluginLoaded, ExperienceId));
+	}
+}
+
+void UGameExperiencePrewarmSubsystem::OnGameFeaturePluginLoaded(const UE::GameFeatures::FResult& Result, FPrimaryAssetId ExperienceId)
+{
+	if (FPrewarmedExperience* Prewarm = PrewarmedExperiences.Find(ExperienceId))
+	{
+		--Prewarm->NumPluginsLoading;
+	}
+}
+
+void UGameExperiencePrewarmSubsystem::ReleasePrewarmedExperience(FPrimaryAssetId ExperienceId)
+{
+	FPrewarmedExperience Prewarm;
+	if (!PrewarmedExperiences.RemoveAndCopyValue(ExperienceId, Prewarm))
+	{
+		return;
+	}
+
+	UE_LOG(LogGameExperience, Log, TEXT("Releasing prewarmed GameExperience '%s'"), *ExperienceId.ToString());
+
+	// releasing also stops any in-progress loads once they complete
+	if (Prewarm.DefinitionHandle.IsValid())
+	{
+		Prewarm.DefinitionHandle->ReleaseHandle();
+	}
+	if (Prewarm.BundleHandle.IsValid())
+	{
+		Prewarm.BundleHandle->ReleaseHandle();
+	}
+
+	// unload plugins that the prewarm loaded, and that weren't activated by an experience in the meantime
+	UGameExperienceEngineSubsystem* EngineSubsystem = UGameExperienceEngineSubsystem::Get();
+	for (const FString& PluginURL : Prewarm.GameFeaturePluginURLs)
+	{
+		EngineSubsystem->UnpinGameFeaturePlugin(PluginURL);
+
+		if (Prewarm.LoadedPluginURLs.Contains(PluginURL) &&
+			EngineSubsystem->GetGameFeaturePluginRefCount(PluginURL) == 0 && !EngineSubsystem->IsGameFeaturePluginPinned(PluginURL))
+		{
+			UGameFeaturesSubsystem::Get().UnloadGameFeaturePlugin(PluginURL);
+		}
+	}
+}
+
+void UGameExperiencePrewarmSubsystem::ReleaseAllPrewarmedExperiences()
+{
+	TArray<FPrimaryAssetId> ExperienceIds;
+	PrewarmedExperiences.GetKeys(ExperienceIds);
+
+	for (const FPrimaryAssetId& ExperienceId : ExperienceIds)
+	{
+		ReleasePrewarmedExperience(ExperienceId);
+	}
+}
+
+bool UGameExperiencePrewarmSubsystem::IsExperiencePrewarmed(FPrimaryAssetId ExperienceId) const
+{
+	const FPrewarmedExperience* Prewarm = PrewarmedExperiences.Find(ExperienceId);
+	return Prewarm && Prewarm->IsLoaded();
+}
+
+void UGameExperiencePrewarmSubsystem::OnExperienceLoading(UGameExperienceComponent* ExperienceComp, const UGameExperienceDef* Experience)
+{
+	const UWorld* World = ExperienceComp ? ExperienceComp->GetWorld() : nullptr;
+	if (!World || World->GetGameInstance() != GetGameInstance() || !Experience)
+	{
+		return;
+	}
+
+	const FPrimaryAssetId ExperienceId = Experience->GetPrimaryAssetId();
+
+	// release anything that isn't needed by this experience
+	TArray<FPrimaryAssetId> ExperienceIds;
+	PrewarmedExperiences.GetKeys(ExperienceIds);
+	for (const FPrimaryAssetId& OtherExperienceId : ExperienceIds)
+	{
+		if (OtherExperienceId != ExperienceId)
+		{
+			ReleasePrewarmedExperience(OtherExperienceId);
+		}
+	}
+
+	// keep the matching experience loaded until the component is done and holds its own references
+	if (PrewarmedExperiences.Contains(ExperienceId))
+	{
+		ExperienceComp->CallOrRegisterOnExperienceLoaded(
+			FOnGameExperienceLoaded::FDelegate::CreateUObject(this, &ThisClass::OnExperienceLoaded),
+			EGameExperienceLoadEventPriority::Low);
+	}
+}
+
+void UGameExperiencePrewarmSubsystem::OnExperienceLoaded(const UGameExperienceDef* Experience)
+{
+	if (Experience)
+	{
+		ReleasePrewarmedExperience(Experience->GetPrimaryAssetId());
+	}
+
+	TravelExperienceId = FPrimaryAssetId();
+}
+
+void UGameExperiencePrewarmSubsystem::PrewarmTravelURL(const FURL& URL)
+{
+	const TCHAR* ExperienceOption = URL.GetOption(TEXT("Experience="), nullptr);
+	if (!ExperienceOption || !*ExperienceOption)
+	{
+		return;
+	}
+
+	TravelExperienceId = UGameExperienceComponent::ParseExperiencePrimaryAssetIdFromString(ExperienceOption);
+
+	UE_LOG(LogGameExperience, Log, TEXT("Found GameExperience '%s' in travel URL %s"), *TravelExperienceId.ToString(), *URL.ToString());
+
+	// the replicated experience will release this if it doesn't match
+	PrewarmExperience(TravelExperienceId);
+}
+
+void UGameExperiencePrewarmSubsystem::OnPreLoadMap(const FWorldContext& WorldContext, const FString& MapName)
+{
+	if (WorldContext.OwningGameInstance != GetGameInstance() || !WorldContext.PendingNetGame)
+	{
+		return;
+	}
+
+	if (CVarGameExperiencePrewarmTravelURL.GetValueOnGameThread())
+	{
+		PrewarmTravelURL(WorldContext.PendingNetGame->URL);
+	}
+}
+
+void UGameExperiencePrewarmSubsystem::OnTravelFailure(UWorld* World, ETravelFailure::Type FailureType, const FString& ErrorString)
+{
+	ReleaseTravelExperience(World);
+}
+
+void UGameExperiencePrewarmSubsystem::OnNetworkFailure(UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString)
+{
+	ReleaseTravelExperience(World);
+}
+
+void UGameExperiencePrewarmSubsystem::ReleaseTravelExperience(const UWorld* World)
+{
+	if (TravelExperienceId.IsValid() && (!World || World->GetGameInstance() == GetGameInstance()))
+	{
+		ReleasePrewarmedExperience(TravelExperienceId);
+		TravelExperienceId = FPrimaryAssetId();
+	}
+}
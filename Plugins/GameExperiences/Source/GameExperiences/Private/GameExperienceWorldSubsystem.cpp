@@ -0,0 +1,27 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+
+#include "GameExperienceWorldSubsystem.h"
+
+#include "GameExperienceComponent.h"
+#include "GameExperiencesModule.h"
+
+
+void UGameExperienceWorldSubsystem::RegisterExperienceComponent(UGameExperienceComponent* InExperienceComponent)
+{
+	if (ExperienceComponent && ExperienceComponent != InExperienceComponent)
+	{
+		UE_LOG(LogGameExperience, Warning, TEXT("Replacing experience component %s with %s, only one is supported per world"),
+			*GetPathNameSafe(ExperienceComponent), *GetPathNameSafe(InExperienceComponent));
+	}
+
+	ExperienceComponent = InExperienceComponent;
+}
+
+void UGameExperienceWorldSubsystem::UnregisterExperienceComponent(UGameExperienceComponent* InExperienceComponent)
+{
+	if (ExperienceComponent == InExperienceComponent)
+	{
+		ExperienceComponent = nullptr;
+	}
+}
@@ -5,6 +5,8 @@
 
 DEFINE_LOG_CATEGORY(LogGameExperience);
 
+UE_TRACE_CHANNEL_DEFINE(GameExperienceChannel);
+
 #define LOCTEXT_NAMESPACE "FGameExperiencesModule"
 
 void FGameExperiencesModule::StartupModule()
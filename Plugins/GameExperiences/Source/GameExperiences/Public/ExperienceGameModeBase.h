@@ -32,6 +32,17 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Experience")
 	bool bRestartPlayersOnExperienceLoad;
 
+	/**
+	 * The maximum number of players to restart each frame after the experience loads, or 0 to restart all at once.
+	 * Human players are restarted before bots.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Meta = (ClampMin = "0"), Category = "Experience")
+	int32 MaxPlayerRestartsPerFrame;
+
+	/** The time budget per frame for restarting players after the experience loads, or 0 for no limit. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Meta = (ClampMin = "0", Units = "ms"), Category = "Experience")
+	float PlayerRestartBudgetMs;
+
 	// IGameExperienceProviderInterface
 	virtual FPrimaryAssetId GetDesiredGameExperience(FString& OutDebugSource) const override;
 
@@ -44,10 +55,13 @@ public:
 
 	/**
 	 * Return true if the experience is loaded for a player.
-	 * Can be implemented in subclasses to wait for client experience loads in addition to server.
+	 * Waits for the client to report that its experience has loaded if the player has a UGameExperiencePlayerComponent.
 	 */
 	virtual bool IsPlayerExperienceLoaded(APlayerController* Player) const;
 
+	/** Called when a client has reported that its experience has loaded, queueing the player for restart if needed. */
+	virtual void OnPlayerExperienceLoaded(APlayerController* Player);
+
 protected:
 	/**
 	 * Return the experience component to use.
@@ -59,4 +73,34 @@ protected:
 	bool IsExperienceLoaded() const;
 
 	virtual void OnExperienceLoaded(const UGameExperienceDef* Experience);
+
+	/**
+	 * Return true if a controller in the restart queue can be restarted.
+	 * Uses PlayerCanRestart for players, and bots can restart once the experience is loaded.
+	 */
+	virtual bool ControllerCanRestart(AController* Controller);
+
+	/** Restart the next players in the queue, and continue next frame if the frame budget runs out. */
+	void ProcessPlayerRestartQueue();
+
+	/** Process the restart queue next frame, unless already scheduled. */
+	void SchedulePlayerRestartQueue();
+
+	/** Handle for processing the restart queue on the next frame. */
+	FTimerHandle PlayerRestartTimerHandle;
+
+	/** Players and bots waiting to be restarted after the experience loaded, humans first. */
+	TArray<TWeakObjectPtr<AController>> PlayerRestartQueue;
+
+	/** The index of the next player to restart in PlayerRestartQueue. */
+	int32 PlayerRestartQueueIndex = 0;
+
+	/** The number of players restarted from the queue. */
+	int32 NumQueuedPlayersRestarted = 0;
+
+	/** The number of frames spent restarting players from the queue. */
+	int32 NumPlayerRestartFrames = 0;
+
+	/** The time when restarting players from the queue started. */
+	double PlayerRestartStartTime = 0.0;
 };
@@ -0,0 +1,36 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "GameExperienceAsyncActionInterface.generated.h"
+
+struct FGameFeatureActivatingContext;
+
+
+UINTERFACE(meta = (CannotImplementInterfaceInBlueprint))
+class UGameExperienceAsyncActionInterface : public UInterface
+{
+	GENERATED_BODY()
+};
+
+
+/**
+ * Interface for game feature actions that need more time to activate, e.g. to grant large ability sets or create widgets.
+ * When used in an experience, the experience component waits for all async actions to finish activating
+ * before loading external features. Async actions activate concurrently with each other.
+ * If the experience is deactivated first, OnGameFeatureDeactivating is called as usual and should cancel any work.
+ */
+class GAMEEXPERIENCES_API IGameExperienceAsyncActionInterface
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Called after OnGameFeatureActivating when the action is executed by an experience.
+	 * Return true if activation continues asynchronously, and trigger the callback when finished.
+	 * Return false if there is nothing left to do, in which case the callback must not be triggered.
+	 */
+	virtual bool ActivateAsync(const FGameFeatureActivatingContext& Context, const FSimpleDelegate& CompleteDelegate) = 0;
+};
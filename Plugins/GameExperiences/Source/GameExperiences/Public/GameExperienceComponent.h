@@ -11,8 +11,11 @@
 #include "GameExperienceComponent.generated.h"
 
 class IGameExperienceExternalFeatureInterface;
+class UGameExperienceActionSet;
 class UGameExperienceComponent;
 class UGameExperienceDef;
+class UGameFeatureAction;
+struct FStreamableHandle;
 
 
 UENUM(BlueprintType)
@@ -20,6 +23,8 @@ enum class EGameExperienceLoadState : uint8
 {
 	/** Initial state, the experience is unloaded. */
 	Unloaded,
+	/** The experience definition class is being loaded asynchronously. */
+	LoadingDefinition,
 	/** The experience definition and associated primary assets are loading. */
 	Loading,
 	/** The required GameFeature plugins are loading. */
@@ -36,7 +41,9 @@ enum class EGameExperienceLoadState : uint8
 	/** The experience and all features are fully loaded and gameplay ready. */
 	Loaded,
 	/** Experience has been deactivated due to EndPlay. */
-	Deactivating
+	Deactivating,
+	/** Loading failed, e.g. a required external feature timed out. The experience must be deactivated before loading again. */
+	Failed
 };
 
 
@@ -54,6 +61,44 @@ enum class EGameExperienceLoadEventPriority : uint8
 
 
 DECLARE_MULTICAST_DELEGATE_OneParam(FOnGameExperienceLoaded, const UGameExperienceDef* /*Experience*/);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnGameExperienceLoadFailed, const UGameExperienceDef* /*Experience*/, const FString& /*Reason*/);
+
+
+/**
+ * Wall clock timings recorded while loading an experience, in seconds.
+ * Use experience.DumpLoadStats to log them.
+ */
+struct GAMEEXPERIENCES_API FGameExperienceLoadStats
+{
+	/** The time when loading started. */
+	double StartTime = 0.0;
+
+	/** The total time from the start of loading until the experience was loaded. */
+	double TotalDuration = 0.0;
+
+	/** The time spent in each load state. */
+	TMap<EGameExperienceLoadState, double> StateDurations;
+
+	/** The time from the start of loading until each game feature plugin was active, by plugin URL. */
+	TMap<FString, double> PluginDurations;
+
+	/** The time spent executing each action, in execution order. */
+	TArray<TPair<FString, double>> ActionDurations;
+
+	/** The time from execution until each async action finished activating, in completion order. */
+	TArray<TPair<FString, double>> AsyncActionDurations;
+
+	/** The time each external feature took to load, by feature name. */
+	TMap<FString, double> ExternalFeatureDurations;
+
+	/** The chain of dependent external features that finished last, in load order. */
+	TArray<FString> ExternalFeatureCriticalPath;
+
+	void Reset();
+
+	/** Log all timings. */
+	void Log(const FString& DebugPrefix, const FString& ExperienceName) const;
+};
 
 
 /**
@@ -69,7 +114,23 @@ class GAMEEXPERIENCES_API UGameExperienceComponent
 public:
 	UGameExperienceComponent(const FObjectInitializer& ObjectInitializer);
 
+	/**
+	 * Fully unload the experience's game feature plugins when it is deactivated, instead of only deactivating them.
+	 * Plugins in ResidentGameFeatures are always kept loaded, and plugins still used by other experiences are left active.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Experience")
+	bool bUnloadGameFeaturePlugins = true;
+
+	/** Game feature plugins to keep loaded (but deactivated) when the experience is deactivated, e.g. frequently used plugins. */
+	UPROPERTY(EditDefaultsOnly, Category = "Experience")
+	TArray<FString> ResidentGameFeatures;
+
+	/** Return the experience component of the world of a context object. */
+	static UGameExperienceComponent* Get(const UObject* WorldContextObject);
+
 	virtual void GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	// IGameExperienceProviderInterface
@@ -78,9 +139,20 @@ public:
 	/** Set the current experience automatically from the world settings, game mode or other sources. */
 	virtual void AutoResolveExperience();
 
-	/** Set the current experience and start loading. The experience cannot be changed once set. */
+	/**
+	 * Set the current experience and start loading. Use SwitchExperience to change it once set.
+	 * The experience definition is loaded asynchronously, and only replicated once it is in memory.
+	 */
 	void SetExperience(const FPrimaryAssetId& ExperienceId);
 
+	/**
+	 * Switch to a different experience in place. Server only.
+	 * Action sets, game feature plugins and asset bundles shared with the current experience stay active,
+	 * and only the difference is deactivated or loaded. If the current experience is still loading,
+	 * the switch happens once it has finished.
+	 */
+	void SwitchExperience(const FPrimaryAssetId& ExperienceId);
+
 	/** Return the current experience. */
 	const UGameExperienceDef* GetExperience() const { return Experience; }
 
@@ -91,12 +163,18 @@ public:
 		return Cast<T>(GetExperience());
 	}
 
+	/** Return the load timings of the current experience. */
+	const FGameExperienceLoadStats& GetLoadStats() const { return LoadStats; }
+
 	/** Add an external feature to be loaded after executing game feature actions. */
 	void RegisterExternalFeature(IGameExperienceExternalFeatureInterface* ExternalFeature);
 
 	/** Return true if the experience is fully loaded. */
 	bool IsExperienceLoaded() const;
 
+	/** Return the current loading state of the experience. */
+	EGameExperienceLoadState GetLoadState() const { return LoadState; }
+
 	/**
 	 * Register a delegate to be called when the experience is loaded,
 	 * or call the delegate immediately if the experience is already loaded.
@@ -109,38 +187,91 @@ public:
 	/** Called when any game experience component has started loading. */
 	static FLoadingDelegate OnExperienceLoadingEvent;
 
+	DECLARE_MULTICAST_DELEGATE_TwoParams(FLoadStateChangedDelegate, UGameExperienceComponent* /*ExperienceComp*/, EGameExperienceLoadState /*NewLoadState*/);
+
+	/** Called when the load state of any game experience component has changed. */
+	static FLoadStateChangedDelegate OnExperienceLoadStateChangedEvent;
+
+	/** Called when the experience failed to load. Delegates registered with CallOrRegisterOnExperienceLoaded are not called. */
+	FOnGameExperienceLoadFailed OnExperienceLoadFailedEvent;
+
 protected:
 	void SetLoadState(EGameExperienceLoadState NewLoadState);
 
+	/** Called when the experience definition class has been loaded after SetExperience. */
+	void OnExperienceDefLoaded();
+
+	/** Called when the experience definition class has been loaded after SwitchExperience. */
+	void OnSwitchExperienceDefLoaded(FPrimaryAssetId ExperienceId);
+
+	/** Switch to another experience now if the current one is loaded, otherwise once it has loaded. */
+	void RequestSwitchExperience(UGameExperienceDef* NewExperience);
+
+	/** Deactivate the actions that are not part of a new experience, then continue loading the new experience. */
+	virtual void SwitchToExperience(UGameExperienceDef* NewExperience);
+
+	/** Called once the actions removed by a switch have been deactivated. */
+	void OnSwitchActionsDeactivated();
+
 	/** Start loading the experience, beginning with assets. */
 	virtual void LoadExperience();
 
+	/** Return the plugins and asset bundles to load for the current experience. */
+	virtual FGameExperienceManifest GetExperienceManifest() const;
+
 	/**
 	 * Called when the assets for the experience have been loaded.
-	 * Starts loading the needed game features plugins.
+	 * Starts loading the needed game features plugins, or waits for them if they were already started.
 	 */
 	void OnExperienceAssetsLoaded();
 
-	/** Load the game feature plugins needed by the experience. */
+	/**
+	 * Load the game feature plugins needed by the experience.
+	 * When using experience.PipelinedLoad, this is called alongside the asset load instead of after it.
+	 */
 	void LoadGameFeaturePlugins();
 
 	/**
 	 * Called once any game feature plugin has been loaded.
-	 * Once all game feature plugins are loaded, OnExperienceLoaded will be called.
+	 * Once all game feature plugins and assets are loaded, OnAllGameFeaturePluginsLoaded will be called.
 	 */
-	void OnGameFeaturePluginLoaded(const UE::GameFeatures::FResult& Result);
+	void OnGameFeaturePluginLoaded(const UE::GameFeatures::FResult& Result, FString PluginURL);
 
 	/** Called when all game feature plugins are loaded. */
 	virtual void OnAllGameFeaturePluginsLoaded();
 
-	/** Activate the experience actions. */
+	/**
+	 * Activate the experience actions, then continue to LoadExternalFeatures.
+	 * Actions may be spread over multiple frames, see experience.ExecuteActionsBudgetMs.
+	 */
 	virtual void ExecuteActions();
 
-	/** Start loading any externally registered features, or continue to OnExperienceLoaded. */
+	/** Execute queued actions in order until the queue is empty or the frame budget is used up. */
+	void ExecuteQueuedActions();
+
+	/** Called when an action implementing IGameExperienceAsyncActionInterface has finished activating. */
+	void OnAsyncActionActivated(int32 ActionIndex, double ActionStartTime);
+
+	/**
+	 * Start loading any externally registered features, or continue to OnExperienceLoaded.
+	 * Features are started as soon as all their dependencies have loaded.
+	 */
 	virtual void LoadExternalFeatures();
 
-	/** Called when an external feature is ready. */
-	virtual void OnExternalFeatureLoaded();
+	/** Start loading an external feature whose dependencies have all loaded. */
+	void StartExternalFeature(int32 FeatureIndex);
+
+	/** Called when an external feature is ready, or has been skipped after timing out. */
+	virtual void OnExternalFeatureLoaded(int32 FeatureIndex);
+
+	/** Called when an external feature didn't finish loading before its timeout. */
+	void OnExternalFeatureTimedOut(int32 FeatureIndex);
+
+	/** Record and log the chain of external features that determined the total load time. */
+	void LogExternalFeatureCriticalPath();
+
+	/** Stop loading, cancel any external features that are still loading, and broadcast the failure. */
+	virtual void FailExperienceLoad(const FString& Reason);
 
 	/** Called after all features are fully loaded. */
 	virtual void OnExperienceLoaded();
@@ -154,6 +285,18 @@ protected:
 	/** Called once all actions have been deactivated during experience deactivate. */
 	void OnAllActionsDeactivated();
 
+	/** Load the pending switch experience from scratch, if any, once the previous experience has been fully deactivated. */
+	void LoadPendingSwitchExperience();
+
+	/** Release the experience asset bundles that were loaded, canceling any in-progress load. */
+	void UnloadExperienceAssets();
+
+	/** Unload or deactivate the experience game feature plugins, depending on bUnloadGameFeaturePlugins. */
+	void UnloadGameFeaturePlugins();
+
+	/** Unload or deactivate some of the experience game feature plugins, depending on bUnloadGameFeaturePlugins. */
+	void ReleaseGameFeaturePlugins(const TArray<FString>& PluginURLs);
+
 	/** Called when the experience has been fully loaded, before other events. */
 	FOnGameExperienceLoaded OnExperienceLoadedEvent_HighPriority;
 
@@ -169,17 +312,110 @@ protected:
 	TObjectPtr<UGameExperienceDef> Experience;
 
 	UFUNCTION()
-	void OnRep_Experience();
+	void OnRep_Experience(UGameExperienceDef* OldExperience);
+
+	/** An experience to switch to once the current one has finished loading. */
+	UPROPERTY(Transient)
+	TObjectPtr<UGameExperienceDef> PendingSwitchExperience;
+
+	/** The id of the experience being switched to, while its definition loads. */
+	FPrimaryAssetId PendingSwitchExperienceId;
+
+	/** Handle for the async load of an experience definition class to switch to. */
+	TSharedPtr<FStreamableHandle> SwitchExperienceDefLoadHandle;
+
+	/** The action sets whose actions have been queued for execution, and stay active when switching experiences. */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UGameExperienceActionSet>> ActiveActionSets;
+
+	/** True while deactivating the actions removed by a switch. */
+	bool bSwitchingExperience = false;
+
+	/** Incremented each time actions are deactivated, to ignore pauser callbacks from previous deactivations. */
+	int32 ActionDeactivationSerial = 0;
 
 	/** The current loading state of the experience. */
 	EGameExperienceLoadState LoadState = EGameExperienceLoadState::Unloaded;
 
+	/** Timings recorded while loading the experience. */
+	FGameExperienceLoadStats LoadStats;
+
+	/** The time when the current load state was entered. */
+	double LoadStateStartTime = 0.0;
+
+	/** The id of the experience that was set, available before the definition has loaded. */
+	FPrimaryAssetId PendingExperienceId;
+
+	/** Handle for the async load of the experience definition class. */
+	TSharedPtr<FStreamableHandle> ExperienceDefLoadHandle;
+
+	/** The dependencies of the current experience. */
+	FGameExperienceManifest ExperienceManifest;
+
 	/** List of game feature plugins that were enabled by the experience. */
 	TArray<FString> GameFeaturePluginURLs;
 
+	/** The primary assets whose bundles were loaded for the experience. */
+	TArray<FPrimaryAssetId> BundleAssetIds;
+
+	/** Handle for the experience asset bundle load. */
+	TSharedPtr<FStreamableHandle> BundleLoadHandle;
+
+	/** Used physical memory when the experience started deactivating, for reporting how much was freed. */
+	uint64 DeactivateUsedPhysical = 0;
+
+	/** The name of the experience being deactivated, which is no longer Experience when switching. */
+	FString DeactivatingExperienceName;
+
+	/** All actions of the experience in execution order. */
+	TArray<TWeakObjectPtr<UGameFeatureAction>> QueuedActions;
+
+	/** The number of actions in QueuedActions that have been executed. */
+	int32 NumExecutedActions = 0;
+
+	/** The number of executed actions that are still activating asynchronously. */
+	int32 NumActionsActivating = 0;
+
+	/** Incremented each time actions are executed, to ignore async activation callbacks from previous loads. */
+	int32 ActionActivationSerial = 0;
+
 	/** List of externally registered features to load. */
 	TArray<IGameExperienceExternalFeatureInterface*> ExternalFeatures;
 
+	/** The load state of a registered external feature. */
+	struct FExternalFeatureNode
+	{
+		IGameExperienceExternalFeatureInterface* Feature = nullptr;
+		FString Name;
+
+		/** Indices of features that depend on this one. */
+		TArray<int32> Dependents;
+
+		/** The number of dependencies that haven't loaded yet. */
+		int32 NumPendingDependencies = 0;
+
+		/** The dependency that finished last, and so determined when this feature could start. */
+		int32 CriticalDependency = INDEX_NONE;
+
+		double StartTime = 0.0;
+		double EndTime = 0.0;
+		bool bStarted = false;
+		bool bFinished = false;
+		FTimerHandle TimeoutHandle;
+	};
+
+	/** The external features being loaded, in registration order. */
+	TArray<FExternalFeatureNode> ExternalFeatureNodes;
+
+	/** Incremented each time external features start loading, to ignore callbacks from previous loads. */
+	int32 ExternalFeatureLoadSerial = 0;
+
+	/** True once the experience asset bundles have finished loading. */
+	bool bExperienceAssetsLoaded = false;
+
+	/** True once the game feature plugins have started loading. */
+	bool bGameFeaturePluginsRequested = false;
+
 	int32 NumFeaturePluginsLoading = 0;
 	int32 NumExternalFeaturesLoading = 0;
 	int32 NumExpectedPausers = 0;
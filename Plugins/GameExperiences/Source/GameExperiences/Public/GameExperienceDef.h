@@ -9,6 +9,37 @@
 class UGameExperienceActionSet;
 
 
+/**
+ * The precomputed dependencies of an experience, built during cook
+ * so that they don't need to be gathered from action sets at runtime.
+ */
+USTRUCT(BlueprintType)
+struct GAMEEXPERIENCES_API FGameExperienceManifest
+{
+	GENERATED_BODY()
+
+	/** True if the manifest has been built. */
+	UPROPERTY()
+	bool bIsValid = false;
+
+	/** Names of all game feature plugins used by the experience, in load order and without duplicates. */
+	UPROPERTY(VisibleAnywhere, Category = "Manifest")
+	TArray<FString> GameFeatures;
+
+	/** The primary assets whose bundles are loaded with the experience, including the experience itself. */
+	UPROPERTY(VisibleAnywhere, Category = "Manifest")
+	TArray<FPrimaryAssetId> BundleAssetIds;
+
+	/** The names of all asset bundles defined by BundleAssetIds. */
+	UPROPERTY(VisibleAnywhere, Category = "Manifest")
+	TArray<FName> BundleNames;
+
+	/** The total number of actions in all action sets. */
+	UPROPERTY(VisibleAnywhere, Category = "Manifest")
+	int32 NumActions = 0;
+};
+
+
 /**
  * The definition of a gameplay experience.
  * Declares which game feature plugins and actions should be activated during this experience.
@@ -26,4 +57,19 @@ public:
 	TArray<TObjectPtr<UGameExperienceActionSet>> ActionSets;
 
 	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+
+#if WITH_EDITOR
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
+#endif
+
+	/** Return the manifest that was built during cook, or build it now if there isn't one. */
+	FGameExperienceManifest GetManifest() const;
+
+	/** Gather the dependencies of this experience from its action sets. */
+	void BuildManifest(FGameExperienceManifest& OutManifest) const;
+
+protected:
+	/** The manifest built during cook. Always rebuilt at runtime in the editor, since action sets may have changed. */
+	UPROPERTY()
+	FGameExperienceManifest CookedManifest;
 };
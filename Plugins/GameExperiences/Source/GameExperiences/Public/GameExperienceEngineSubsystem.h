@@ -0,0 +1,101 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFeaturesSubsystem.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "GameExperienceEngineSubsystem.generated.h"
+
+struct FStreamableHandle;
+
+
+/**
+ * Process-wide state shared by all game experience components,
+ * e.g. across PIE clients or multiple matches running in one server process.
+ *
+ * Game feature plugins are reference counted here so that a plugin is only
+ * deactivated once the last experience that uses it has been deactivated.
+ * Experience asset bundles are reference counted the same way, so that experiences
+ * running in different worlds share loads instead of unloading each other's assets.
+ */
+UCLASS()
+class GAMEEXPERIENCES_API UGameExperienceEngineSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UGameExperienceEngineSubsystem* Get();
+
+	/**
+	 * Add a reference to a game feature plugin, loading and activating it if needed.
+	 * The delegate is called once the plugin is active, or immediately if it already is.
+	 */
+	void RequestGameFeaturePlugin(const FString& PluginURL, const FGameFeaturePluginLoadComplete& CompleteDelegate);
+
+	/**
+	 * Remove a reference to a game feature plugin, and deactivate or unload it if it is no longer referenced.
+	 * The delegate is called once the plugin is deactivated or unloaded, or immediately if it is still in use.
+	 */
+	void ReleaseGameFeaturePlugin(const FString& PluginURL, bool bUnload, const FGameFeaturePluginChangeStateComplete& CompleteDelegate);
+
+	/** Return the number of experiences currently using a game feature plugin. */
+	int32 GetGameFeaturePluginRefCount(const FString& PluginURL) const;
+
+	/**
+	 * Keep a game feature plugin loaded, e.g. while it is being prewarmed for an upcoming experience.
+	 * Releasing a pinned plugin only deactivates it, even if it would otherwise be unloaded.
+	 */
+	void PinGameFeaturePlugin(const FString& PluginURL);
+
+	/** Remove a pin added with PinGameFeaturePlugin. */
+	void UnpinGameFeaturePlugin(const FString& PluginURL);
+
+	/** Return true if a game feature plugin is pinned. */
+	bool IsGameFeaturePluginPinned(const FString& PluginURL) const;
+
+	/** Find the URL of a game feature plugin by name, caching the result for future lookups. */
+	bool FindGameFeaturePluginURL(const FString& PluginName, FString& OutPluginURL);
+
+	/**
+	 * Add a reference to the asset bundles of primary assets, loading them if needed.
+	 * Each requester may only reference an asset once, and must release it before requesting it again.
+	 * Returns a new handle that completes once all loads for the assets have finished,
+	 * or null if they are already loaded. The handle must be released, not canceled,
+	 * since the loads it waits on may be shared with other experiences.
+	 */
+	TSharedPtr<FStreamableHandle> RequestAssetBundles(const UObject* Requester, const TArray<FPrimaryAssetId>& AssetIds, const TArray<FName>& BundleNames);
+
+	/** Remove a requester's reference to the asset bundles of primary assets, and unload any that are no longer referenced. */
+	void ReleaseAssetBundles(const UObject* Requester, const TArray<FPrimaryAssetId>& AssetIds);
+
+	/** Return the number of experiences using the asset bundles of a primary asset. */
+	int32 GetAssetBundleRefCount(const FPrimaryAssetId& AssetId) const;
+
+protected:
+	/** A primary asset whose bundles are loaded for one or more experiences. */
+	struct FAssetBundleRef
+	{
+		/** The experience components using the asset. */
+		TSet<FObjectKey> Requesters;
+
+		/** The bundles that have been requested for the asset. */
+		TArray<FName> BundleNames;
+
+		/** The most recent load of the asset's bundles. */
+		TSharedPtr<FStreamableHandle> LoadHandle;
+	};
+
+	/** Primary assets with loaded bundles, by id. */
+	TMap<FPrimaryAssetId, FAssetBundleRef> AssetBundleRefs;
+
+	/** Game feature plugin URLs that have been resolved, by plugin name. */
+	TMap<FString, FString> GameFeaturePluginURLsByName;
+
+	/** The number of experiences using each game feature plugin, by plugin URL. */
+	TMap<FString, int32> GameFeaturePluginRefCounts;
+
+	/** The number of pins on each game feature plugin, by plugin URL. */
+	TMap<FString, int32> GameFeaturePluginPinCounts;
+};
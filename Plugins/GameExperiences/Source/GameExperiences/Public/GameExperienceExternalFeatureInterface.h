@@ -7,6 +7,17 @@
 #include "GameExperienceExternalFeatureInterface.generated.h"
 
 
+/** What to do when an external feature doesn't finish loading before its timeout. */
+UENUM(BlueprintType)
+enum class EGameExperienceExternalFeatureTimeoutPolicy : uint8
+{
+	/** Log a warning and continue as if the feature had loaded, including any features that depend on it. */
+	Skip,
+	/** Log an error and stop loading the experience. */
+	Fail,
+};
+
+
 UINTERFACE(meta = (CannotImplementInterfaceInBlueprint))
 class UGameExperienceExternalFeatureInterface : public UInterface
 {
@@ -27,4 +38,19 @@ public:
 
 	/** Load this feature and trigger the callback when finished. */
 	virtual void LoadFeature(const FSimpleDelegate& CompleteDelegate) = 0;
+
+	/** Stop loading this feature and release anything it started, called if the experience fails to load while it is still loading. */
+	virtual void CancelFeatureLoad();
+
+	/**
+	 * Return the names of other registered features that must finish loading before this one starts.
+	 * Features without dependencies on each other are loaded in parallel.
+	 */
+	virtual TArray<FString> GetFeatureDependencies() const;
+
+	/** Return the time in seconds this feature may take to load, or 0 to wait forever. */
+	virtual float GetFeatureTimeout() const;
+
+	/** Return what to do if this feature doesn't finish loading before its timeout. */
+	virtual EGameExperienceExternalFeatureTimeoutPolicy GetFeatureTimeoutPolicy() const;
 };
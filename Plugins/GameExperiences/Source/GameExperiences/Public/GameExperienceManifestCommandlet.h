@@ -0,0 +1,23 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GameExperienceManifestCommandlet.generated.h"
+
+
+/**
+ * Builds the manifest of every game experience and writes them to a json file for inspecting offline.
+ * Usage: -run=GameExperienceManifest [-Output=Path/To/ExperienceManifests.json]
+ */
+UCLASS()
+class GAMEEXPERIENCES_API UGameExperienceManifestCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UGameExperienceManifestCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,58 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UGameExperienceDef;
+
+
+/**
+ * The resident memory attributable to the action sets, asset bundles and
+ * game feature plugins of an experience, for budgeting memory per mode.
+ *
+ * Only packages that are currently loaded count towards resident memory,
+ * so the report reflects whatever the experience has pulled in at the time it is built.
+ */
+struct GAMEEXPERIENCES_API FGameExperienceMemoryReport
+{
+	/** The packages and memory of one part of an experience. */
+	struct FEntry
+	{
+		/** The action set, bundle or plugin name. */
+		FString Name;
+
+		/** The number of packages referenced, including hard dependencies. */
+		int32 NumPackages = 0;
+
+		/** The number of referenced packages that are loaded. */
+		int32 NumLoadedPackages = 0;
+
+		/** The memory used by objects in loaded packages, in bytes. */
+		int64 ResidentBytes = 0;
+	};
+
+	/** Memory per action set, including the experience itself. A package is only counted once, for the first action set that uses it. */
+	TArray<FEntry> ActionSets;
+
+	/** Memory per bundle name, across all action sets. */
+	TArray<FEntry> Bundles;
+
+	/** Memory per game feature plugin, for content mounted by the plugin. */
+	TArray<FEntry> Plugins;
+
+	/** The memory used by all packages of the experience, counting shared packages once. */
+	int64 TotalResidentBytes = 0;
+
+	/** Build the report for an experience, only walking the given bundles, or all of the experience's bundles if empty. */
+	void Build(const UGameExperienceDef* Experience, const TArray<FName>& BundleNamesFilter = TArray<FName>());
+
+	/** Log the report. */
+	void Log(const FString& ExperienceName) const;
+
+	/** Return the report as csv rows, one per entry. */
+	FString ToCsv(const FString& ExperienceName) const;
+
+	/** Return the resident memory of a package, or 0 if it is not loaded. */
+	static int64 GetPackageResidentBytes(FName PackageName, bool& bOutIsLoaded);
+};
@@ -0,0 +1,24 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GameExperienceMemoryReportCommandlet.generated.h"
+
+
+/**
+ * Loads the asset bundles of each game experience in isolation and reports the resident memory
+ * attributable to its action sets, bundles and game feature plugins.
+ * Usage: -run=GameExperienceMemoryReport [-Experience=GameExperienceDef:Name] [-Bundles=Client,Server] [-Output=Path/To/MemoryReport.csv]
+ */
+UCLASS()
+class GAMEEXPERIENCES_API UGameExperienceMemoryReportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UGameExperienceMemoryReportCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
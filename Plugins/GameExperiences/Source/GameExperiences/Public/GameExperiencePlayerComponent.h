@@ -0,0 +1,62 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameExperienceComponent.h"
+#include "Components/ControllerComponent.h"
+#include "GameExperiencePlayerComponent.generated.h"
+
+
+/**
+ * A player controller component that reports the client's experience load state to the server,
+ * so that the server can wait for clients to finish loading before restarting them.
+ * Add to player controllers to enable AExperienceGameModeBase::IsPlayerExperienceLoaded checks.
+ */
+UCLASS(Meta = (BlueprintSpawnableComponent))
+class GAMEEXPERIENCES_API UGameExperiencePlayerComponent : public UControllerComponent
+{
+	GENERATED_BODY()
+
+public:
+	UGameExperiencePlayerComponent(const FObjectInitializer& ObjectInitializer);
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Return the experience load state last reported by the owning client. */
+	EGameExperienceLoadState GetClientLoadState() const { return ClientLoadState; }
+
+	/** Return true if the owning client has reported that its experience is fully loaded. */
+	bool IsClientExperienceLoaded() const { return ClientLoadState == EGameExperienceLoadState::Loaded; }
+
+	/** Return the time in seconds from BeginPlay on the server until the client finished loading, or a negative value if not loaded yet. */
+	double GetClientLoadDuration() const;
+
+	/** Return the experience player component of a controller, if any. */
+	static UGameExperiencePlayerComponent* FindForController(const AController* Controller);
+
+protected:
+	/** The experience load state reported by the owning client. Only valid on the server. */
+	EGameExperienceLoadState ClientLoadState = EGameExperienceLoadState::Unloaded;
+
+	/** The load state last sent to the server. Only valid on the owning client. */
+	EGameExperienceLoadState LastReportedLoadState = EGameExperienceLoadState::Unloaded;
+
+	/** The time when this component began play on the server. */
+	double ServerStartTime = 0.0;
+
+	/** The time when the client reported that it finished loading. */
+	double ClientLoadedTime = 0.0;
+
+	void OnExperienceLoadStateChanged(UGameExperienceComponent* ExperienceComp, EGameExperienceLoadState NewLoadState);
+
+	/** Send a load state to the server if it has changed. */
+	void ReportLoadState(EGameExperienceLoadState NewLoadState);
+
+	/** Update the client load state on the server. */
+	void SetClientLoadState(EGameExperienceLoadState NewLoadState);
+
+	UFUNCTION(Server, Reliable)
+	void ServerReportLoadState(EGameExperienceLoadState NewLoadState);
+};
@@ -0,0 +1,126 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFeaturePluginOperationResult.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Engine/StreamableManager.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "GameExperiencePrewarmSubsystem.generated.h"
+
+class UGameExperienceComponent;
+class UGameExperienceDef;
+class UGameExperienceEntryPoint;
+class UNetDriver;
+
+
+/**
+ * Loads experiences ahead of time, e.g. from a lobby before traveling to the map,
+ * so that the experience component finds everything resident and finishes loading quickly.
+ *
+ * Prewarmed experiences are kept loaded across travel until an experience has finished
+ * loading in this game instance, at which point they are released automatically.
+ *
+ * Clients also prewarm the experience found in the options of the URL they are traveling to,
+ * so that loading starts while the map loads instead of once the game state has replicated.
+ * This only covers client URLs with an explicit ?Experience= option. Session joins and plain
+ * "open ip:port" URLs don't carry the host's options, so call PrewarmExperienceByName with
+ * the experience advertised in the session's search result before joining.
+ */
+UCLASS()
+class GAMEEXPERIENCES_API UGameExperiencePrewarmSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Start loading an experience definition, its asset bundles and game feature plugins.
+	 * Plugins are loaded but not activated, so that they don't affect the current world.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "GameExperience")
+	void PrewarmExperience(FPrimaryAssetId ExperienceId);
+
+	/**
+	 * Prewarm an experience from its name, e.g. as advertised in an online session's settings.
+	 * Supports both "GameExperienceDef.MyExperience" and "MyExperience".
+	 */
+	UFUNCTION(BlueprintCallable, Category = "GameExperience")
+	void PrewarmExperienceByName(const FString& ExperienceName);
+
+	/** Prewarm the experience of an entry point, if it has one. */
+	UFUNCTION(BlueprintCallable, Category = "GameExperience")
+	void PrewarmEntryPoint(const UGameExperienceEntryPoint* EntryPoint);
+
+	/** Release everything that was loaded for a prewarmed experience. */
+	UFUNCTION(BlueprintCallable, Category = "GameExperience")
+	void ReleasePrewarmedExperience(FPrimaryAssetId ExperienceId);
+
+	/** Release all prewarmed experiences. */
+	UFUNCTION(BlueprintCallable, Category = "GameExperience")
+	void ReleaseAllPrewarmedExperiences();
+
+	/** Return true if an experience was prewarmed and has finished loading. */
+	UFUNCTION(BlueprintPure, Category = "GameExperience")
+	bool IsExperiencePrewarmed(FPrimaryAssetId ExperienceId) const;
+
+	/** Prewarm the experience from the Experience option of a travel URL, if it has one. */
+	void PrewarmTravelURL(const FURL& URL);
+
+protected:
+	struct FPrewarmedExperience
+	{
+		/** Handle for the experience definition class. */
+		TSharedPtr<FStreamableHandle> DefinitionHandle;
+
+		/** Handle for the preloaded asset bundles. */
+		TSharedPtr<FStreamableHandle> BundleHandle;
+
+		/** The game feature plugins of the experience, which are pinned while prewarmed. */
+		TArray<FString> GameFeaturePluginURLs;
+
+		/** The game feature plugins that weren't loaded before prewarming, and may be unloaded again on release. */
+		TArray<FString> LoadedPluginURLs;
+
+		int32 NumPluginsLoading = 0;
+		bool bDefinitionLoaded = false;
+
+		bool IsLoaded() const
+		{
+			return bDefinitionLoaded && NumPluginsLoading == 0 && (!BundleHandle.IsValid() || BundleHandle->HasLoadCompleted());
+		}
+	};
+
+	/** All prewarmed experiences by id. */
+	TMap<FPrimaryAssetId, FPrewarmedExperience> PrewarmedExperiences;
+
+	/** The experience prewarmed from the last travel URL, released if travel fails. */
+	FPrimaryAssetId TravelExperienceId;
+
+	FDelegateHandle ExperienceLoadingHandle;
+	FDelegateHandle PreLoadMapHandle;
+	FDelegateHandle TravelFailureHandle;
+	FDelegateHandle NetworkFailureHandle;
+
+	/** Called before loading a map, to prewarm the experience of a pending net game. */
+	void OnPreLoadMap(const FWorldContext& WorldContext, const FString& MapName);
+
+	void OnTravelFailure(UWorld* World, ETravelFailure::Type FailureType, const FString& ErrorString);
+	void OnNetworkFailure(UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString);
+
+	/** Release the experience prewarmed from a travel URL, if it was for this game instance. */
+	void ReleaseTravelExperience(const UWorld* World);
+
+	void OnDefinitionLoaded(FPrimaryAssetId ExperienceId);
+
+	void OnGameFeaturePluginLoaded(const UE::GameFeatures::FResult& Result, FPrimaryAssetId ExperienceId);
+
+	/** Called when any experience component starts loading. */
+	void OnExperienceLoading(UGameExperienceComponent* ExperienceComp, const UGameExperienceDef* Experience);
+
+	/** Called when an experience in this game instance has finished loading. */
+	void OnExperienceLoaded(const UGameExperienceDef* Experience);
+};
@@ -0,0 +1,33 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameExperienceWorldSubsystem.generated.h"
+
+class UGameExperienceComponent;
+
+
+/**
+ * Keeps track of the experience component of a world, so it can be found without searching the game state.
+ */
+UCLASS()
+class GAMEEXPERIENCES_API UGameExperienceWorldSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Return the experience component of the world. */
+	UGameExperienceComponent* GetExperienceComponent() const { return ExperienceComponent; }
+
+	/** Set the experience component of the world. Called automatically when the component is registered. */
+	void RegisterExperienceComponent(UGameExperienceComponent* InExperienceComponent);
+
+	/** Clear the experience component of the world, if it is the current one. */
+	void UnregisterExperienceComponent(UGameExperienceComponent* InExperienceComponent);
+
+protected:
+	UPROPERTY(Transient)
+	TObjectPtr<UGameExperienceComponent> ExperienceComponent;
+};
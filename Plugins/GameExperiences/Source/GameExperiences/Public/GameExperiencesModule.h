@@ -4,9 +4,13 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "Trace/Trace.h"
 
 GAMEEXPERIENCES_API DECLARE_LOG_CATEGORY_EXTERN(LogGameExperience, Log, All);
 
+/** Insights trace channel for profiling experience loading. Enable with -trace=cpu,GameExperience. */
+UE_TRACE_CHANNEL_EXTERN(GameExperienceChannel, GAMEEXPERIENCES_API);
+
 
 class FGameExperiencesModule : public IModuleInterface
 {
@@ -0,0 +1,22 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class GameExperiencesBenchmark : ModuleRules
+{
+	public GameExperiencesBenchmark(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PublicDependencyModuleNames.AddRange(new string[]
+		{
+			"Core",
+		});
+
+		PrivateDependencyModuleNames.AddRange(new string[]
+		{
+			"CoreUObject",
+			"Engine",
+			"GameExperiences",
+			"GameFeatures",
+		});
+	}
+}
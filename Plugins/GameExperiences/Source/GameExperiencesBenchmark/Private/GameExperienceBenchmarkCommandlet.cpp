@@ -0,0 +1,257 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+
+#include "GameExperienceBenchmarkCommandlet.h"
+
+#include "GameExperienceActionSet.h"
+#include "GameExperienceDef.h"
+#include "GameExperiencesModule.h"
+#include "Tickable.h"
+#include "Containers/Ticker.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "Misc/FileHelper.h"
+#include "UObject/StrongObjectPtr.h"
+#include "UObject/UObjectGlobals.h"
+
+
+namespace GameExperienceBenchmark
+{
+	/** Averaged timings of one benchmark case, in seconds. */
+	struct FResult
+	{
+		int32 NumActions = 0;
+		int32 NumIterations = 0;
+		double Total = 0.0;
+		double Loading = 0.0;
+		double ExecutingActions = 0.0;
+		double LoadingExternalFeatures = 0.0;
+		double PerAction = 0.0;
+		double Deactivate = 0.0;
+		double Frames = 0.0;
+	};
+
+	constexpr float TickDeltaSeconds = 1.f / 60.f;
+	constexpr int32 MaxFrames = 10000;
+
+	/** Tick the world and anything else the load pipeline depends on for one frame. */
+	void TickFrame(UWorld* World)
+	{
+		ProcessAsyncLoading(true, false, 0.005f);
+		FTSTicker::GetCoreTicker().Tick(TickDeltaSeconds);
+		World->Tick(LEVELTICK_All, TickDeltaSeconds);
+		FTickableGameObject::TickObjects(World, LEVELTICK_All, false, TickDeltaSeconds);
+	}
+
+	/** Tick until the component reaches a load state, returning the number of frames ticked or INDEX_NONE on timeout. */
+	int32 TickUntilState(UWorld* World, const UGameExperienceComponent* Component, EGameExperienceLoadState State)
+	{
+		int32 NumFrames = 0;
+		while (Component->GetLoadState() != State)
+		{
+			if (NumFrames >= MaxFrames)
+			{
+				return INDEX_NONE;
+			}
+			TickFrame(World);
+			++NumFrames;
+		}
+		return NumFrames;
+	}
+
+	/** Create a transient experience with the given number of no-op actions. */
+	UGameExperienceDef* CreateExperience(int32 NumActions)
+	{
+		UGameExperienceDef* Experience = NewObject<UGameExperienceDef>(GetTransientPackage(),
+			MakeUniqueObjectName(GetTransientPackage(), UGameExperienceDef::StaticClass(), *FString::Printf(TEXT("BenchmarkExperience_%d"), NumActions)));
+
+		UGameExperienceActionSet* ActionSet = NewObject<UGameExperienceActionSet>(Experience);
+		ActionSet->Actions.Reserve(NumActions);
+		for (int32 Idx = 0; Idx < NumActions; ++Idx)
+		{
+			ActionSet->Actions.Add(NewObject<UGameFeatureAction_Benchmark>(ActionSet));
+		}
+
+		Experience->ActionSets.Add(ActionSet);
+		return Experience;
+	}
+}
+
+
+// UGameExperienceBenchmarkCommandlet
+// ----------------------------------
+
+UGameExperienceBenchmarkCommandlet::UGameExperienceBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UGameExperienceBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace GameExperienceBenchmark;
+
+	FString ActionCountsString = TEXT("1,10,100,1000");
+	FParse::Value(*Params, TEXT("Actions="), ActionCountsString);
+
+	int32 NumIterations = 5;
+	FParse::Value(*Params, TEXT("Iterations="), NumIterations);
+	NumIterations = FMath::Max(NumIterations, 1);
+
+	int32 NumExternalFeatures = 4;
+	FParse::Value(*Params, TEXT("ExternalFeatures="), NumExternalFeatures);
+
+	FString OutputPath;
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	TArray<FString> ActionCountStrings;
+	ActionCountsString.ParseIntoArray(ActionCountStrings, TEXT(","));
+
+	// create a game world with a game state to host the experience component
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("GameExperienceBenchmark"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	AGameStateBase* GameState = World->SpawnActor<AGameStateBase>();
+	UGameExperienceBenchmarkComponent* Component = NewObject<UGameExperienceBenchmarkComponent>(GameState);
+	Component->RegisterComponent();
+
+	// the features are reused for every iteration, keep them alive through the garbage collection between iterations
+	TArray<TStrongObjectPtr<UGameExperienceBenchmarkFeature>> ExternalFeatures;
+	for (int32 Idx = 0; Idx < NumExternalFeatures; ++Idx)
+	{
+		ExternalFeatures.Emplace(NewObject<UGameExperienceBenchmarkFeature>(Component));
+	}
+
+	TArray<FResult> Results;
+	bool bSuccess = true;
+
+	for (const FString& ActionCountString : ActionCountStrings)
+	{
+		FResult& Result = Results.AddDefaulted_GetRef();
+		Result.NumActions = FCString::Atoi(*ActionCountString);
+
+		for (int32 Iteration = 0; Iteration < NumIterations && bSuccess; ++Iteration)
+		{
+			UGameExperienceDef* Experience = CreateExperience(Result.NumActions);
+
+			for (const TStrongObjectPtr<UGameExperienceBenchmarkFeature>& ExternalFeature : ExternalFeatures)
+			{
+				Component->RegisterExternalFeature(ExternalFeature.Get());
+			}
+
+			Component->LoadBenchmarkExperience(Experience);
+
+			const int32 NumFrames = TickUntilState(World, Component, EGameExperienceLoadState::Loaded);
+			if (NumFrames == INDEX_NONE)
+			{
+				UE_LOG(LogGameExperience, Error, TEXT("Timed out loading experience with %d actions (state: %s)"), Result.NumActions,
+					*StaticEnum<EGameExperienceLoadState>()->GetNameStringByValue((uint8)Component->GetLoadState()));
+				bSuccess = false;
+				break;
+			}
+
+			const FGameExperienceLoadStats& Stats = Component->GetLoadStats();
+			Result.Total += Stats.TotalDuration;
+			Result.Loading += Stats.StateDurations.FindRef(EGameExperienceLoadState::Loading);
+			Result.ExecutingActions += Stats.StateDurations.FindRef(EGameExperienceLoadState::ExecutingActions);
+			Result.LoadingExternalFeatures += Stats.StateDurations.FindRef(EGameExperienceLoadState::LoadingExternalFeatures);
+			for (const TPair<FString, double>& ActionDuration : Stats.ActionDurations)
+			{
+				Result.PerAction += ActionDuration.Value;
+			}
+			Result.Frames += NumFrames;
+
+			const double DeactivateStartTime = FPlatformTime::Seconds();
+			Component->UnloadBenchmarkExperience();
+			if (TickUntilState(World, Component, EGameExperienceLoadState::Unloaded) == INDEX_NONE)
+			{
+				UE_LOG(LogGameExperience, Error, TEXT("Timed out unloading experience with %d actions"), Result.NumActions);
+				bSuccess = false;
+				break;
+			}
+			Result.Deactivate += FPlatformTime::Seconds() - DeactivateStartTime;
+			++Result.NumIterations;
+
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		}
+
+		if (Result.NumIterations > 0)
+		{
+			const double Scale = 1.0 / Result.NumIterations;
+			Result.Total *= Scale;
+			Result.Loading *= Scale;
+			Result.ExecutingActions *= Scale;
+			Result.LoadingExternalFeatures *= Scale;
+			Result.PerAction *= Scale / FMath::Max(Result.NumActions, 1);
+			Result.Deactivate *= Scale;
+			Result.Frames *= Scale;
+		}
+	}
+
+	ExternalFeatures.Reset();
+	Component->DestroyComponent();
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	// report
+	FString Csv = TEXT("Actions,Iterations,TotalMs,LoadingMs,ExecutingActionsMs,LoadingExternalFeaturesMs,PerActionUs,DeactivateMs,Frames\n");
+
+	UE_LOG(LogGameExperience, Display, TEXT("%8s %10s %10s %10s %10s %10s %10s %8s"),
+		TEXT("Actions"), TEXT("Total ms"), TEXT("Loading"), TEXT("Actions"), TEXT("External"), TEXT("us/action"), TEXT("Deact ms"), TEXT("Frames"));
+
+	for (const FResult& Result : Results)
+	{
+		UE_LOG(LogGameExperience, Display, TEXT("%8d %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f %8.1f"),
+			Result.NumActions, Result.Total * 1000.0, Result.Loading * 1000.0, Result.ExecutingActions * 1000.0,
+			Result.LoadingExternalFeatures * 1000.0, Result.PerAction * 1000000.0, Result.Deactivate * 1000.0, Result.Frames);
+
+		Csv += FString::Printf(TEXT("%d,%d,%f,%f,%f,%f,%f,%f,%f\n"),
+			Result.NumActions, Result.NumIterations, Result.Total * 1000.0, Result.Loading * 1000.0, Result.ExecutingActions * 1000.0,
+			Result.LoadingExternalFeatures * 1000.0, Result.PerAction * 1000000.0, Result.Deactivate * 1000.0, Result.Frames);
+	}
+
+	if (!OutputPath.IsEmpty() && !FFileHelper::SaveStringToFile(Csv, *OutputPath))
+	{
+		UE_LOG(LogGameExperience, Error, TEXT("Failed to write benchmark results to %s"), *OutputPath);
+		return 1;
+	}
+
+	return bSuccess ? 0 : 1;
+}
+
+
+// UGameExperienceBenchmarkComponent
+// ---------------------------------
+
+UGameExperienceBenchmarkComponent::UGameExperienceBenchmarkComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	SetIsReplicatedByDefault(false);
+}
+
+void UGameExperienceBenchmarkComponent::LoadBenchmarkExperience(UGameExperienceDef* InExperience)
+{
+	Experience = InExperience;
+	LoadExperience();
+}
+
+void UGameExperienceBenchmarkComponent::UnloadBenchmarkExperience()
+{
+	DeactivateExperience();
+}
+
+FGameExperienceManifest UGameExperienceBenchmarkComponent::GetExperienceManifest() const
+{
+	FGameExperienceManifest Manifest = Super::GetExperienceManifest();
+
+	// benchmark experiences are created at runtime and aren't known to the asset manager, so they have no bundles
+	Manifest.BundleAssetIds.Reset();
+	Manifest.BundleNames.Reset();
+	return Manifest;
+}
@@ -0,0 +1,73 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameExperienceComponent.h"
+#include "GameExperienceExternalFeatureInterface.h"
+#include "GameFeatureAction.h"
+#include "Commandlets/Commandlet.h"
+#include "GameExperienceBenchmarkCommandlet.generated.h"
+
+
+/**
+ * Loads synthetic experiences with increasing numbers of no-op actions in a headless game world,
+ * and reports the time spent in each phase of the load pipeline.
+ * Usage: -run=GameExperienceBenchmark -nullrhi [-Actions=1,10,100,1000] [-Iterations=5] [-ExternalFeatures=4] [-Output=Path/To/Results.csv]
+ */
+UCLASS()
+class UGameExperienceBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UGameExperienceBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
+
+
+/**
+ * A game feature action that does nothing, used to measure the overhead of executing actions.
+ */
+UCLASS(HideDropdown, NotBlueprintable)
+class UGameFeatureAction_Benchmark : public UGameFeatureAction
+{
+	GENERATED_BODY()
+};
+
+
+/**
+ * An external feature that completes immediately, used to measure the overhead of loading external features.
+ */
+UCLASS(Transient)
+class UGameExperienceBenchmarkFeature : public UObject, public IGameExperienceExternalFeatureInterface
+{
+	GENERATED_BODY()
+
+public:
+	virtual FString GetFeatureName() const override { return GetName(); }
+	virtual void LoadFeature(const FSimpleDelegate& CompleteDelegate) override { CompleteDelegate.ExecuteIfBound(); }
+};
+
+
+/**
+ * An experience component that can load experiences which are not registered with the asset manager.
+ */
+UCLASS(Transient, HideDropdown, NotBlueprintable)
+class UGameExperienceBenchmarkComponent : public UGameExperienceComponent
+{
+	GENERATED_BODY()
+
+public:
+	UGameExperienceBenchmarkComponent(const FObjectInitializer& ObjectInitializer);
+
+	/** Start loading an experience directly, skipping the definition load. */
+	void LoadBenchmarkExperience(UGameExperienceDef* InExperience);
+
+	/** Deactivate the current experience. */
+	void UnloadBenchmarkExperience();
+
+protected:
+	virtual FGameExperienceManifest GetExperienceManifest() const override;
+};
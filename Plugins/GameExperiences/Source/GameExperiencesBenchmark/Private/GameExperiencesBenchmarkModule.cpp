@@ -0,0 +1,6 @@
+﻿// Copyright Bohdon Sayre, All Rights Reserved.
+
+#include "Modules/ModuleManager.h"
+
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, GameExperiencesBenchmark)